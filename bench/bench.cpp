@@ -0,0 +1,796 @@
+#include <idlib/math.hpp>
+#include <idlib/color.hpp>
+#include <idlib/soa.hpp>
+#include <idlib/quat.hpp>
+#include <idlib/ray.hpp>
+#include <idlib/cull.hpp>
+#include <idlib/predicates.hpp>
+#include <idlib/transcendental.hpp>
+#include <idlib/bc.hpp>
+#include <idlib/vertex.hpp>
+#include <idlib/parallel.hpp>
+#include <idlib/view.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <x86intrin.h>
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENT 1
+#endif
+
+using namespace id::math::type;
+
+/* cycle counter, perf_event core cycles where the kernel allows it and rdtsc reference cycles otherwise */
+class cycle_counter
+{
+	int fd = -1;
+public:
+	cycle_counter()
+	{
+#if defined(HAVE_PERF_EVENT)
+		perf_event_attr attr = {};
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CPU_CYCLES;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~cycle_counter()
+	{
+#if defined(HAVE_PERF_EVENT)
+		if(fd >= 0)
+			close(fd);
+#endif
+	}
+	const char* source() const { return fd >= 0 ? "perf" : "rdtsc"; }
+	uint64_t now() const
+	{
+#if defined(HAVE_PERF_EVENT)
+		uint64_t c;
+		if(fd >= 0 && read(fd, &c, sizeof(c)) == sizeof(c))
+			return c;
+#endif
+		return __rdtsc();
+	}
+};
+
+struct result
+{
+	std::string kernel;
+	std::string type;
+	std::string impl;
+	std::string level;
+	size_t n;
+	double ns_op;
+	double elems_s;
+	double cycles_op;
+};
+
+/* working set sizes of one pass over source and destination */
+static constexpr std::pair<const char*, size_t> levels[] = { { "L1", 16 << 10 }, { "L2", 512 << 10 }, { "DRAM", 64 << 20 } };
+
+static cycle_counter counter;
+static std::vector<result> results;
+static std::string filter;
+static std::chrono::nanoseconds min_time = std::chrono::milliseconds(50);
+static std::mt19937 rng(1);
+
+/* keep the compiler from dropping stores into dst */
+inline void clobber(void* dst) { asm volatile("" : : "r"(dst) : "memory"); }
+
+/* time f(src, dst) over n elements at every cache level, S is the scalar the source is filled with */
+template<sca S, typename In, typename Out, typename F>
+void run(const char* kernel, const char* type, const char* impl, F&& f)
+{
+	if(kernel != filter && std::string(kernel).find(filter) == std::string::npos)
+		return;
+
+	for(auto [level, bytes] : levels)
+	{
+		const size_t n = std::max<size_t>(1, bytes / (sizeof(In) + sizeof(Out)));
+		std::vector<In> src(n);
+		std::vector<Out> dst(n);
+		std::span<S> fill((S*)src.data(), n * sizeof(In) / sizeof(S));
+		for(S& s : fill)
+			if constexpr(std::is_floating_point_v<S>)
+				s = std::uniform_real_distribution<S>(-1, 1)(rng);
+			else
+				s = (S)rng();
+
+		f(std::span<const In>(src), std::span<Out>(dst));
+		size_t reps = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		uint64_t c0 = counter.now();
+		std::chrono::nanoseconds t;
+		do
+		{
+			f(std::span<const In>(src), std::span<Out>(dst));
+			clobber(dst.data());
+			reps++;
+			t = std::chrono::steady_clock::now() - t0;
+		} while(t < min_time);
+		uint64_t c = counter.now() - c0;
+
+		const double ops = (double)reps * n;
+		results.push_back({ kernel, type, impl, level, n, t.count() / ops, ops / (t.count() * 1e-9), c / ops });
+	}
+}
+
+/* plain loop references the SIMD kernels are measured against */
+template<sca T>
+T det3_scalar(const T m[3][3])
+{
+	return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+	     - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+	     + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+template<sca T>
+T cofactor_scalar(const mat<T,4,4>& m, size_t r, size_t c)
+{
+	T s[3][3];
+	for(size_t i = 0, k = 0; i < 4; i++)
+		if(i != r)
+		{
+			for(size_t j = 0, l = 0; j < 4; j++)
+				if(j != c)
+					s[k][l++] = m[i][j];
+			k++;
+		}
+	return ((r + c) % 2 ? -1 : 1) * det3_scalar<T>(s);
+}
+
+template<sca T>
+T det_scalar(const mat<T,4,4>& m)
+{
+	T d = 0;
+	for(size_t c = 0; c < 4; c++)
+		d += m[0][c] * cofactor_scalar<T>(m, 0, c);
+	return d;
+}
+
+template<sca T>
+void inverse_scalar(const mat<T,4,4>& m, mat<T,4,4>& dst)
+{
+	T d = det_scalar<T>(m);
+	for(size_t r = 0; r < 4; r++)
+		for(size_t c = 0; c < 4; c++)
+			dst[c][r] = cofactor_scalar<T>(m, r, c) / d;
+}
+
+/* 4x4 matrix as a std::vector element */
+template<sca T>
+using mat4 = std::array<vec<T,4>,4>;
+
+template<sca T>
+const mat<T,4,4>& as_mat(const mat4<T>& m) { return *(const mat<T,4,4>*)m.data(); }
+template<sca T>
+mat<T,4,4>& as_mat(mat4<T>& m) { return *(mat<T,4,4>*)m.data(); }
+
+template<sca T>
+void bench_matrix(const char* type)
+{
+	run<T, mat4<T>, T>("det4", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = det<T>(as_mat<T>(src[i]));
+	});
+	run<T, mat4<T>, T>("det4", type, "batch", [](auto src, auto dst)
+	{
+		det<T>(std::span((const mat<T,4,4>*)src.data(), src.size()), dst);
+	});
+	run<T, mat4<T>, T>("det4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = det_scalar<T>(as_mat<T>(src[i]));
+	});
+	run<T, mat4<T>, mat4<T>>("inverse4", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			inverse<T>(as_mat<T>(src[i]), as_mat<T>(dst[i]));
+	});
+	run<T, mat4<T>, mat4<T>>("inverse4", type, "batch", [](auto src, auto dst)
+	{
+		inverse<T>(std::span((const mat<T,4,4>*)src.data(), src.size()), std::span((mat<T,4,4>*)dst.data(), dst.size()));
+	});
+	run<T, mat4<T>, mat4<T>>("inverse4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			inverse_scalar<T>(as_mat<T>(src[i]), as_mat<T>(dst[i]));
+	});
+	run<T, mat4<T>, mat4<T>>("mul4", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			mul<T>(as_mat<T>(src[i]), as_mat<T>(src[src.size() - 1 - i]), as_mat<T>(dst[i]));
+	});
+	run<T, mat4<T>, mat4<T>>("mul4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t c = 0; c < 4; c++)
+				for(size_t r = 0; r < 4; r++)
+				{
+					T s = 0;
+					for(size_t k = 0; k < 4; k++)
+						s += src[i][k][r] * src[src.size() - 1 - i][c][k];
+					dst[i][c][r] = s;
+				}
+	});
+	run<T, mat4<T>, mat4<T>>("transpose4", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			transpose<T,4,4>(as_mat<T>(src[i]), as_mat<T>(dst[i]));
+	});
+	run<T, mat4<T>, mat4<T>>("transpose4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t c = 0; c < 4; c++)
+				for(size_t r = 0; r < 4; r++)
+					dst[i][r][c] = src[i][c][r];
+	});
+	/* the buffer as a row-major matrix 256 columns wide */
+	run<T, T, T>("transpose", type, "batch", [](auto src, auto dst)
+	{
+		transpose<T>(src, dst, src.size() / 256, 256);
+	});
+	run<T, T, T>("transpose", type, "scalar", [](auto src, auto dst)
+	{
+		const size_t rows = src.size() / 256;
+		for(size_t r = 0; r < rows; r++)
+			for(size_t c = 0; c < 256; c++)
+				dst[c * rows + r] = src[r * 256 + c];
+	});
+}
+
+template<sca T>
+void bench_vector(const char* type)
+{
+	using V = vec<T,4>;
+	using pair = std::array<V,2>;
+
+	run<T, pair, V>("cross3", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			if constexpr(std::is_same_v<T, vecf_t>)
+				dst[i] = _mm_cross3_ps(src[i][0], src[i][1]);
+			else
+				dst[i] = _mm_cross3_pd(src[i][0], src[i][1]);
+	});
+	run<T, pair, V>("cross3", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			const T* a = (const T*)&src[i][0];
+			const T* b = (const T*)&src[i][1];
+			T* d = (T*)&dst[i];
+			d[0] = a[1] * b[2] - a[2] * b[1];
+			d[1] = a[2] * b[0] - a[0] * b[2];
+			d[2] = a[0] * b[1] - a[1] * b[0];
+			d[3] = 0;
+		}
+	});
+	if constexpr(std::is_same_v<T, vecd_t>)
+	{
+		run<T, pair, V>("dot4", type, "simd", [](auto src, auto dst)
+		{
+			for(size_t i = 0; i < src.size(); i++)
+				dst[i] = _mm256_dp_pd(src[i][0], src[i][1], 0xff);
+		});
+		run<T, pair, V>("dot4", type, "mask", [](auto src, auto dst)
+		{
+			for(size_t i = 0; i < src.size(); i++)
+				dst[i] = _mm256_dp_pd<0xff>(src[i][0], src[i][1]);
+		});
+	}
+	run<T, pair, T>("dot4", type, "batch", [](auto src, auto dst)
+	{
+		/* pairs interleave a and b, so every other vector of the source feeds each side */
+		const size_t n = src.size();
+		std::span<const V> v((const V*)src.data(), 2 * n);
+		dot<T>(v.first(n), v.last(n), dst);
+	});
+	run<T, pair, V>("dot4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			T s = 0;
+			for(size_t k = 0; k < 4; k++)
+				s += src[i][0][k] * src[i][1][k];
+			dst[i] = (V){ s, s, s, s };
+		}
+	});
+	run<T, V, V>("permute4", type, "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = permute<T,4,3,1,2,0>(src[i]);
+	});
+	run<T, V, V>("permute4", type, "runtime", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = permute<T,4>(src[i], 3, 1, 2, 0);
+	});
+	run<T, V, V>("permute4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			const T* s = (const T*)&src[i];
+			dst[i] = (V){ s[3], s[1], s[2], s[0] };
+		}
+	});
+	run<T, vec<T,3>, vec<T,3>>("transform_points", type, "batch", [](auto src, auto dst)
+	{
+		static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+		transform_points<T>(m, src, dst);
+	});
+	run<T, vec<T,3>, vec<T,3>>("transform_points", type, "scalar", [](auto src, auto dst)
+	{
+		static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t r = 0; r < 3; r++)
+				dst[i][r] = m[0][r] * src[i][0] + m[1][r] * src[i][1] + m[2][r] * src[i][2] + m[3][r];
+	});
+	run<T, V, V>("transform", type, "batch", [](auto src, auto dst)
+	{
+		static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+		transform<T>(m, src, dst);
+	});
+	run<T, V, V>("transform", type, "scalar", [](auto src, auto dst)
+	{
+		static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t r = 0; r < 4; r++)
+				dst[i][r] = m[0][r] * src[i][0] + m[1][r] * src[i][1] + m[2][r] * src[i][2] + m[3][r] * src[i][3];
+	});
+	/* positions of interleaved 8-component vertex records, transformed through strided views or copied out and back */
+	using vertex = std::array<T,8>;
+	run<T, vertex, vertex>("transform_points interleaved", type, "view", [](auto src, auto dst)
+	{
+		apply_views([](auto s, auto d)
+		{
+			static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+			return transform_points<T>(m, s, d);
+		}, view<const vec<T,3>>(src.data(), src.size(), sizeof(vertex)),
+		      view<vec<T,3>>(dst.data(), dst.size(), sizeof(vertex)));
+	});
+	run<T, vertex, vertex>("transform_points interleaved", type, "copy", [](auto src, auto dst)
+	{
+		static const mat<T,4,4> m = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{1,2,3,1}};
+		static std::vector<vec<T,3>> in, out;
+		in.resize(src.size());
+		out.resize(src.size());
+		for(size_t i = 0; i < src.size(); i++)
+			std::memcpy(&in[i], &src[i], sizeof(in[i]));
+		transform_points<T>(m, in, out);
+		for(size_t i = 0; i < dst.size(); i++)
+			std::memcpy(&dst[i], &out[i], sizeof(out[i]));
+	});
+	run<T, vec<T,3>, T>("plane distance", type, "batch", [](auto src, auto dst)
+	{
+		static const vec<T,4> plane = { 0.48, 0.6, 0.64, -0.25 };
+		distance<T>(src, plane, dst);
+	});
+	run<T, vec<T,3>, T>("plane distance", type, "scalar", [](auto src, auto dst)
+	{
+		static const vec<T,4> plane = { 0.48, 0.6, 0.64, -0.25 };
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			vec<T,4> p = (vec<T,4>){ src[i][0], src[i][1], src[i][2], 1 } * plane;
+			dst[i] = (p[0] + p[1]) + (p[2] + p[3]);
+		}
+	});
+	run<T, vec<T,3>, pvec<T,3>>("load3", type, "batch", [](auto src, auto dst)
+	{
+		load<T,3>(src, dst);
+	});
+	run<T, vec<T,3>, pvec<T,3>>("load3", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = (pvec<T,3>){ src[i][0], src[i][1], src[i][2], 0 };
+	});
+	run<T, pvec<T,3>, vec<T,3>>("store3", type, "batch", [](auto src, auto dst)
+	{
+		store<T,3>(src, dst);
+	});
+	run<T, pvec<T,3>, vec<T,3>>("store3", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t c = 0; c < 3; c++)
+				dst[i][c] = src[i][c];
+	});
+	run<T, vec<T,3>, vec<T,3>>("planar3", type, "batch", [](auto src, auto dst)
+	{
+		transpose<T>(std::span((const T*)src.data(), 3 * src.size()), std::span((T*)dst.data(), 3 * dst.size()), src.size(), 3);
+	});
+	run<T, vec<T,3>, vec<T,3>>("planar3", type, "scalar", [](auto src, auto dst)
+	{
+		T* d = (T*)dst.data();
+		for(size_t i = 0; i < src.size(); i++)
+			for(size_t c = 0; c < 3; c++)
+				d[c * src.size() + i] = src[i][c];
+	});
+	run<T, vec<T,3>, vec<T,3>>("normalize3", type, "soa", [](auto src, auto dst)
+	{
+		static aosoa<T,3> p;
+		if(p.size() != src.size())
+			p = aosoa<T,3>(src.size());
+		p.assign(src);
+		apply([](auto a) { return normalize(a); }, p, p);
+		p.copy(dst);
+	});
+	run<T, vec<T,3>, vec<T,3>>("normalize3", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			T l = std::sqrt(src[i][0] * src[i][0] + src[i][1] * src[i][1] + src[i][2] * src[i][2]);
+			T r = l > 0 ? 1 / l : 0;
+			for(size_t c = 0; c < 3; c++)
+				dst[i][c] = src[i][c] * r;
+		}
+	});
+}
+
+template<sca T>
+void bench_quat(const char* type)
+{
+	using pair = std::array<quat<T>,2>;
+
+	/* joints resident in SoA form, the blend itself without the AoS round trip */
+	run<T, pair, quat<T>>("slerp", type, "soa", [](auto src, auto dst)
+	{
+		static soa<T,4> a, b, d;
+		if(a.size() != src.size())
+		{
+			std::vector<quat<T>> qa(src.size()), qb(src.size());
+			for(size_t i = 0; i < src.size(); i++)
+				qa[i] = src[i][0], qb[i] = src[i][1];
+			a = soa<T,4>(qa), b = soa<T,4>(qb), d = soa<T,4>(src.size());
+		}
+		slerp(d, a, b, (T)0.3);
+		clobber(&d);
+	});
+	run<T, pair, quat<T>>("slerp", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = slerp(src[i][0], src[i][1], (T)0.3);
+	});
+	run<T, pair, quat<T>>("nlerp", type, "soa", [](auto src, auto dst)
+	{
+		static soa<T,4> a, b, d;
+		if(a.size() != src.size())
+		{
+			std::vector<quat<T>> qa(src.size()), qb(src.size());
+			for(size_t i = 0; i < src.size(); i++)
+				qa[i] = src[i][0], qb[i] = src[i][1];
+			a = soa<T,4>(qa), b = soa<T,4>(qb), d = soa<T,4>(src.size());
+		}
+		nlerp(d, a, b, (T)0.3);
+		clobber(&d);
+	});
+	run<T, pair, quat<T>>("nlerp", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = nlerp(src[i][0], src[i][1], (T)0.3);
+	});
+	run<T, quat<T>, mat4<T>>("quat>mat4", type, "soa", [](auto src, auto dst)
+	{
+		static soa<T,4> q;
+		if(q.size() != src.size())
+			q = soa<T,4>(src);
+		to_mat(q, std::span<mat<T,4,4>>((mat<T,4,4>*)dst.data(), dst.size()));
+	});
+	run<T, quat<T>, mat4<T>>("quat>mat4", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			to_mat<T>(src[i], as_mat<T>(dst[i]));
+	});
+}
+
+template<sca T>
+void bench_ray(const char* type)
+{
+	using tri = std::array<vec<T,3>,3>;
+
+	run<T, tri, T>("raycast", type, "aosoa", [](auto src, auto dst)
+	{
+		const vec<T,3> o = { 0, 0, -2 }, d = { (T)0.1, (T)0.2, 1 };
+		static aosoa<T,3> v0, v1, v2;
+		if(v0.size() != src.size())
+		{
+			std::vector<vec<T,3>> a(src.size()), b(src.size()), c(src.size());
+			for(size_t i = 0; i < src.size(); i++)
+				a[i] = src[i][0], b[i] = src[i][1], c[i] = src[i][2];
+			v0 = aosoa<T,3>(a), v1 = aosoa<T,3>(b), v2 = aosoa<T,3>(c);
+		}
+		dst[0] = raycast(o, d, v0, v1, v2, (T)100).second;
+	});
+	run<T, tri, T>("raycast", type, "scalar", [](auto src, auto dst)
+	{
+		const vec<T,3> o = { 0, 0, -2 }, d = { (T)0.1, (T)0.2, 1 };
+		T best = 100;
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			const vec<T,3>& a = src[i][0];
+			vec<T,3> e1 = { src[i][1][0] - a[0], src[i][1][1] - a[1], src[i][1][2] - a[2] };
+			vec<T,3> e2 = { src[i][2][0] - a[0], src[i][2][1] - a[1], src[i][2][2] - a[2] };
+			vec<T,3> s = { o[0] - a[0], o[1] - a[1], o[2] - a[2] };
+			vec<T,3> p = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+			T det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+			if(det == 0)
+				continue;
+			T r = 1 / det, u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * r;
+			if(u < 0 || u > 1)
+				continue;
+			vec<T,3> q = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+			T v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * r;
+			if(v < 0 || u + v > 1)
+				continue;
+			T t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * r;
+			if(t > 0 && t < best)
+				best = t;
+		}
+		dst[0] = best;
+	});
+}
+
+/* unit cube view volume, boxes around the origin straddle or fall outside it */
+template<sca T>
+std::span<const plane<T>> unit_frustum()
+{
+	static const plane<T> f[6] = { { 1, 0, 0, 1 }, { -1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, -1, 0, 1 }, { 0, 0, 1, 1 }, { 0, 0, -1, 1 } };
+	return f;
+}
+
+template<sca T>
+void bench_cull(const char* type)
+{
+	using box = std::array<vec<T,3>,2>;
+
+	run<T, box, u8<1>>("cull boxes", type, "soa", [](auto src, auto dst)
+	{
+		static soa<T,3> lo, hi;
+		if(lo.size() != src.size())
+		{
+			std::vector<vec<T,3>> a(src.size()), b(src.size());
+			for(size_t i = 0; i < src.size(); i++)
+				for(size_t c = 0; c < 3; c++)
+					a[i][c] = std::min(src[i][0][c], src[i][1][c]), b[i][c] = std::max(src[i][0][c], src[i][1][c]) + 1;
+			lo = soa<T,3>(a), hi = soa<T,3>(b);
+		}
+		std::span<u64<1>> bits((u64<1>*)dst.data(), dst.size() / 16);
+		cull_boxes(lo, hi, unit_frustum<T>(), bits.first(bits.size() / 2), bits.last(bits.size() / 2));
+	});
+	run<T, box, u8<1>>("cull boxes", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			vec<T,3> lo, hi;
+			for(size_t c = 0; c < 3; c++)
+				lo[c] = std::min(src[i][0][c], src[i][1][c]), hi[c] = std::max(src[i][0][c], src[i][1][c]) + 1;
+			u8<1> s = 1;
+			for(const plane<T>& p : unit_frustum<T>())
+			{
+				side b = box_on_plane_side<T>(lo, hi, p);
+				if(b == side::back)
+				{
+					s = 0;
+					break;
+				}
+				s |= (u8<1>)b & 2;
+			}
+			dst[i] = s;
+		}
+	});
+}
+
+template<sca T>
+void bench_predicates(const char* type)
+{
+	using tet = std::array<vec<T,3>,4>;
+
+	run<T, tet, i8<1>>("orient3d", type, "batch", [](auto src, auto dst)
+	{
+		static std::vector<vec<T,3>> a, b, c, d;
+		if(a.size() != src.size())
+		{
+			a.resize(src.size()), b.resize(src.size()), c.resize(src.size()), d.resize(src.size());
+			for(size_t i = 0; i < src.size(); i++)
+				a[i] = src[i][0], b[i] = src[i][1], c[i] = src[i][2], d[i] = src[i][3];
+		}
+		orient3d<T>(a, b, c, d, dst);
+	});
+	run<T, tet, i8<1>>("orient3d", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = orient3d<T>(src[i][0], src[i][1], src[i][2], src[i][3]);
+	});
+}
+
+template<sca T>
+void bench_transcendental(const char* type)
+{
+	run<T, T, T>("sin", type, "accurate", [](auto src, auto dst) { sin<precision::accurate, T>(src, dst); });
+	run<T, T, T>("sin", type, "fast", [](auto src, auto dst) { sin<precision::fast, T>(src, dst); });
+	run<T, T, T>("sin", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = std::sin(src[i]);
+	});
+	run<T, vec<T,3>, vec<T,3>>("normalize", type, "accurate", [](auto src, auto dst) { normalize<precision::accurate, T>(src, dst); });
+	run<T, vec<T,3>, vec<T,3>>("normalize", type, "fast", [](auto src, auto dst) { normalize<precision::fast, T>(src, dst); });
+	run<T, vec<T,3>, vec<T,3>>("normalize", type, "par", [](auto src, auto dst)
+	{
+		parallel(par, [](auto s, auto d) { return normalize<precision::fast, T>(s, d); }, src, dst);
+	});
+	run<T, vec<T,3>, vec<T,3>>("normalize", type, "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			T l = std::sqrt(src[i][0] * src[i][0] + src[i][1] * src[i][1] + src[i][2] * src[i][2]), r = l > 0 ? 1 / l : 0;
+			dst[i] = { src[i][0] * r, src[i][1] * r, src[i][2] * r };
+		}
+	});
+}
+
+void bench_color()
+{
+	using rgba = col::u32<col::rgba8888>;
+	using rgb = col::u16<col::rgb565>;
+
+	run<u8<1>, rgba, vec4f_t>("color rgba8888>f32", "u32", "batch", [](auto src, auto dst)
+	{
+		col::convert<col::rgba8888, col::rgbaf32>(src, dst);
+	});
+	run<u8<1>, rgba, vec4f_t>("color rgba8888>f32", "u32", "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = (vec4f_t)src[i];
+	});
+	run<u8<1>, rgb, byte_vec4_t>("color rgb565>u8", "u16", "simd", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = (byte_vec4_t)src[i];
+	});
+	run<u8<1>, rgb, rgba>("color rgb565>rgba8888", "u16", "batch", [](auto src, auto dst)
+	{
+		col::convert<col::rgb565, col::rgba8888>(src, dst);
+	});
+	run<vecf_t, vecf_t, u8<1>>("unorm f32>u8", "f32", "batch", [](auto src, auto dst)
+	{
+		vector_cast<u8<1>, rounding::nearest, scaling::unorm>(src, dst);
+	});
+	run<vecf_t, vecf_t, u8<1>>("unorm f32>u8", "f32", "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = (u8<1>)::lroundf(std::clamp(src[i], 0.0f, 1.0f) * 255);
+	});
+
+	/* one element is a block of a 4 texel high strip, opaque rgb565 keeps BC1 in its four color mode */
+	using block = std::array<rgb,16>;
+	using texels = std::array<rgba,16>;
+	const auto strip = [](std::span<const block> src) { return std::span<const rgb>(src.data()->data(), src.size() * 16); };
+	run<u8<1>, block, col::bc1_block>("bc1 encode", "u16", "range", [&](auto src, auto dst)
+	{
+		col::encode_bc1<col::rgb565, col::bc_fit::range>(strip(src), src.size() * 4, 4, dst);
+	});
+	run<u8<1>, block, col::bc1_block>("bc1 encode", "u16", "cluster", [&](auto src, auto dst)
+	{
+		col::encode_bc1<col::rgb565, col::bc_fit::cluster>(strip(src), src.size() * 4, 4, dst);
+	});
+	run<u8<1>, block, col::bc1_block>("bc1 encode", "u16", "threads", [&](auto src, auto dst)
+	{
+		col::encode_bc1<col::rgb565, col::bc_fit::range>(strip(src), src.size() * 4, 4, dst, 0);
+	});
+	run<u8<1>, col::bc3_block, texels>("bc3 decode", "u32", "batch", [](auto src, auto dst)
+	{
+		col::decode_bc3<col::rgba8888>(src, dst.size() * 4, 4, std::span<rgba>(dst.data()->data(), dst.size() * 16));
+	});
+}
+
+void bench_vertex()
+{
+	run<f32<1>, f32<1>, f16<1>>("half pack", "f32", "batch", [](auto src, auto dst) { pack_half(src, dst); });
+	run<f32<1>, f32<1>, f16<1>>("half pack", "f32", "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = std::bit_cast<f16<1>>((_Float16)src[i]);
+	});
+	run<f32<1>, vec<f32<1>,3>, oct<32>>("oct encode", "f32", "fast", [](auto src, auto dst) { encode_oct<32, precision::fast, f32<1>>(src, dst); });
+	run<f32<1>, vec<f32<1>,3>, oct<32>>("oct encode", "f32", "accurate", [](auto src, auto dst) { encode_oct<32, precision::accurate, f32<1>>(src, dst); });
+	run<f32<1>, vec<f32<1>,3>, oct<32>>("oct encode", "f32", "scalar", [](auto src, auto dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+		{
+			const vec<f32<1>,3>& n = src[i];
+			f32<1> l = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]), x = n[0] / l, y = n[1] / l;
+			if(n[2] < 0)
+			{
+				const f32<1> fx = (1 - std::abs(y)) * (x < 0 ? -1 : 1), fy = (1 - std::abs(x)) * (y < 0 ? -1 : 1);
+				x = fx, y = fy;
+			}
+			dst[i] = (oct<32>){ (i16<1>)::lroundf(x * 32767), (i16<1>)::lroundf(y * 32767) };
+		}
+	});
+	run<u8<1>, oct<32>, vec<f32<1>,3>>("oct decode", "f32", "batch", [](auto src, auto dst) { decode_oct<32, precision::accurate, f32<1>>(src, dst); });
+	run<f32<1>, vec<f32<1>,3>, vec<i16<1>,4>>("quantize snorm16", "f32", "batch", [](auto src, auto dst)
+	{
+		quantize<i16<1>, f32<1>>(src, { { 1, 1, 1 }, { 0, 0, 0 } }, dst);
+	});
+	run<f32<1>, vec<f32<1>,4>, i32<1>>("pack 2_10_10_10", "f32", "batch", [](auto src, auto dst) { pack_2_10_10_10_rev<f32<1>>(src, dst); });
+}
+
+const char* tier_name(simd_tier t)
+{
+	switch(t)
+	{
+		case simd_tier::sse41:  return "sse4.1";
+		case simd_tier::avx2:   return "avx2";
+		case simd_tier::avx512: return "avx512";
+		default:                return "sse2";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool json = false;
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if(arg == "--json")
+			json = true;
+		else if(arg.starts_with("--filter="))
+			filter = arg.substr(9);
+		else if(arg.starts_with("--min-time="))
+			min_time = std::chrono::milliseconds(std::stoul(arg.substr(11)));
+		else
+		{
+			fprintf(stderr, "usage: %s [--json] [--filter=kernel] [--min-time=ms]\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	bench_matrix<vecf_t>("f32");
+	bench_matrix<vecd_t>("f64");
+	bench_vector<vecf_t>("f32");
+	bench_vector<vecd_t>("f64");
+	bench_quat<vecf_t>("f32");
+	bench_quat<vecd_t>("f64");
+	bench_ray<vecf_t>("f32");
+	bench_ray<vecd_t>("f64");
+	bench_cull<vecf_t>("f32");
+	bench_cull<vecd_t>("f64");
+	bench_predicates<vecf_t>("f32");
+	bench_predicates<vecd_t>("f64");
+	bench_transcendental<vecf_t>("f32");
+	bench_transcendental<vecd_t>("f64");
+	bench_color();
+	bench_vertex();
+
+	/* kernel counters of an IDLIB_PROFILE build */
+	if(profile_enabled)
+		fputs(profile_json().c_str(), stderr);
+
+	if(json)
+	{
+		printf("{\n\t\"simd\": \"%s\",\n\t\"cycles\": \"%s\",\n\t\"results\": [\n", tier_name(simd_active()), counter.source());
+		for(size_t i = 0; i < results.size(); i++)
+		{
+			const result& r = results[i];
+			printf("\t\t{ \"kernel\": \"%s\", \"type\": \"%s\", \"impl\": \"%s\", \"level\": \"%s\", \"n\": %zu, \"ns_op\": %.4f, \"elems_s\": %.6g, \"cycles_op\": %.4f }%s\n",
+			       r.kernel.c_str(), r.type.c_str(), r.impl.c_str(), r.level.c_str(), r.n, r.ns_op, r.elems_s, r.cycles_op, i + 1 < results.size() ? "," : "");
+		}
+		printf("\t]\n}\n");
+	}
+	else
+	{
+		printf("simd %s, cycles from %s\n", tier_name(simd_active()), counter.source());
+		printf("%-24s %-4s %-8s %-5s %10s %10s %12s %10s\n", "kernel", "type", "impl", "level", "n", "ns/op", "elems/s", "cycles/op");
+		for(const result& r : results)
+			printf("%-24s %-4s %-8s %-5s %10zu %10.3f %12.4g %10.3f\n", r.kernel.c_str(), r.type.c_str(), r.impl.c_str(), r.level.c_str(), r.n, r.ns_op, r.elems_s, r.cycles_op);
+	}
+	exit(EXIT_SUCCESS);
+}
@@ -1,4 +1,8 @@
 #include <idlib/math.hpp>
+#include <idlib/color.hpp>
+#include <idlib/soa.hpp>
+#include <idlib/quat.hpp>
+#include <idlib/predicates.hpp>
 
 using namespace id::math::type;
 
@@ -16,7 +20,27 @@ int main(int argc, char** argv)
 	printf("color: [%f %f %f %f]: %zu/%zu\n", cf[0], cf[1], cf[2], cf[3], sizeof(v4), alignof(v4));
 	printf("color: [%hhu %hhu %hhu %hhu]: %zu/%zu\n", cfb[0], cfb[1], cfb[2], cfb[3], sizeof(v4), alignof(v4));
 	printf("color: [%hhu %hhu %hhu]: %zu/%zu\n", c[0], c[1], c[2], sizeof(c), alignof(c));
+	col::u32<col::argb8888> ca[1];
+	col::convert<col::rgb565, col::argb8888>(std::span(&c, 1), ca);
+	printf("color: [%hhu %hhu %hhu %hhu]: %zu/%zu\n", ca[0][0], ca[0][1], ca[0][2], ca[0][3], sizeof(ca[0]), alignof(ca[0]));
 	
+	vec3f_t pts[3] = {{3,0,4},{0,2,0},{1,1,1}};
+	aosoa<vecf_t, 3> p(pts);
+	apply([](auto a) { return normalize(a); }, p, p);
+	p.copy(pts);
+	printf("soa: [%f %f %f]: %zu/%zu\n", pts[0][0], pts[0][1], pts[0][2], p.size(), p.packets());
+
+	quatf_t qa = { 0, 0, 0, 1 }, qb = { 0, 0, 0.70710678f, 0.70710678f };
+	vec3f_t r = rotate<vecf_t>(slerp(qa, qb, 0.5f), vec3f_t{ 1, 0, 0 });
+	printf("quat: [%f %f %f]\n", r[0], r[1], r[2]);
+
+	/* counterclockwise triangle whose determinant underflows, decided by the rescaled exact stage */
+	int o = orient2d<vecd_t>(vec2d_t{ 0, 0 }, vec2d_t{ 1e-170, 0 }, vec2d_t{ 0, 1e-170 });
+	int i = incircle<vecd_t>(vec2d_t{ 0, 0 }, vec2d_t{ 1e-100, 0 }, vec2d_t{ 0, 1e-100 }, vec2d_t{ 2e-101, 2e-101 });
+	printf("predicates: %d %d\n", o, i);
+	if(o != 1 || i != 1)
+		exit(EXIT_FAILURE);
+
 	printf("v3: [%f %f %f]: %zu/%zu\n", v3[0], v3[1], v3[2], sizeof(v3), alignof(v3));
 	printf("v4: [%f %f %f %f]: %zu/%zu\n", v4[0], v4[1], v4[2], v4[3], sizeof(v4), alignof(v4));
 	exit(EXIT_SUCCESS);
@@ -0,0 +1,507 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/color.hpp>
+#include <idlib/parallel.hpp>
+
+namespace id::math::type::col
+{
+	/* BC1 (DXT1) block, two endpoints in the bgr565 layout and the 2-bit palette indices of the 16 texels in row
+	   major order, texel i in bits 2i. c0 > c1 selects four colors, otherwise three and transparent black */
+	struct bc1_block
+	{
+		type::u16<1> c0, c1;
+		type::u32<1> idx;
+	};
+
+	/* BC4 block, the BC3 alpha, two 8-bit endpoints and the 3-bit palette indices of the 16 texels, texel i in bits
+	   3i. a0 > a1 selects eight values, otherwise six and 0 and 255 */
+	struct bc4_block
+	{
+		type::u8<1> a0, a1;
+		type::u8<1> idx[6];
+	};
+
+	/* BC3 (DXT5) block, alpha then a color block always decoded with four colors */
+	struct bc3_block
+	{
+		bc4_block alpha;
+		bc1_block color;
+	};
+
+	/* endpoint fit, range takes the extremes of the texels projected on their principal axis, cluster searches every
+	   ordered partition along the axis into the four palette entries for the least squares endpoints. BC3 alpha with
+	   cluster also tries the six value mode */
+	enum class bc_fit { range, cluster };
+
+	/* one lane per texel of a block, a 64-byte vector the helpers below only pass and return always_inline so the
+	   clones of each tier lower it to their own registers */
+	using bc_lanes = vector_aligned<vecf_t,16>;
+	using bc_index = lane_mask<bc_lanes>;
+
+	static constexpr bc_index bc_lane = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+	/* f folded over the lanes of v by halves */
+	template<typename V, typename F>
+	inline __attribute__((__always_inline__)) auto bc_fold(V v, F&& f)
+	{
+		static constexpr size_t N = lane_traits<V>::size;
+		if constexpr(N == 2)
+			return f(v[0], v[1]);
+		else
+			return [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				return bc_fold(f(__builtin_shufflevector(v, v, I...), __builtin_shufflevector(v, v, (I + N / 2)...)), f);
+			}(std::make_index_sequence<N / 2>{});
+	}
+
+	inline __attribute__((__always_inline__)) vecf_t bc_sum(bc_lanes v) { return bc_fold(v, [](auto a, auto b) { return a + b; }); }
+	inline __attribute__((__always_inline__)) vecf_t bc_min(bc_lanes v) { return bc_fold(v, [](auto a, auto b) { return a < b ? a : b; }); }
+	inline __attribute__((__always_inline__)) vecf_t bc_max(bc_lanes v) { return bc_fold(v, [](auto a, auto b) { return a < b ? b : a; }); }
+
+	/* lanes l of idx in bits B l of one word, the halves of the block are packed separately to stay in 32-bit lanes */
+	template<size_t B>
+	inline __attribute__((__always_inline__)) type::u64<1> bc_pack(bc_index idx)
+	{
+		using U = vector_aligned<type::u32<1>,16>;
+		const U w = __builtin_convertvector(idx, U) << __builtin_convertvector(bc_lane % 8 * (type::i32<1>)B, U);
+		const auto or_ = [](auto a, auto b) { return a | b; };
+		return bc_fold(bc_lane < 8 ? w : 0, or_) | (type::u64<1>)bc_fold(bc_lane < 8 ? 0 : w, or_) << (8 * B);
+	}
+
+	/* lanes l of the indices in bits B l of w */
+	template<size_t B>
+	inline __attribute__((__always_inline__)) bc_index bc_unpack(type::u64<1> w)
+	{
+		static constexpr type::u64<1> half = ((type::u64<1>)1 << (8 * B)) - 1;
+		const bc_index lo = (bc_index){} + (type::i32<1>)(w & half), hi = (bc_index){} + (type::i32<1>)(w >> (8 * B) & half);
+		return ((bc_lane < 8 ? lo : hi) >> (bc_lane % 8 * (type::i32<1>)B)) & ((1 << B) - 1);
+	}
+
+	/* bgr565 endpoint expanded to 8-bit channels by bit replication */
+	inline __attribute__((__always_inline__)) vec4f_t bc_expand(type::u16<1> c)
+	{
+		u16<bgr565> e;
+		e.c3 = c;
+		const int r = e.r(), g = e.g(), b = e.b();
+		return (vec4f_t){ (vecf_t)(r << 3 | r >> 2), (vecf_t)(g << 2 | g >> 4), (vecf_t)(b << 3 | b >> 2), 255 };
+	}
+
+	/* nearest bgr565 endpoint of rgb e in 0..255 */
+	inline __attribute__((__always_inline__)) type::u16<1> bc_quantize(vec4f_t e)
+	{
+		e = e > 0 ? e : 0;
+		e = e < 255 ? e : 255;
+		const vec4i_t q = __builtin_convertvector(e * (vec4f_t){ 31, 63, 31, 0 } / 255 + 0.5f, vec4i_t);
+		return u16<bgr565>(q[0], q[1], q[2]).c3;
+	}
+
+	/* BC1 palette, three colors and transparent black unless four */
+	inline __attribute__((__always_inline__)) std::array<vec4f_t,4> bc1_palette(type::u16<1> c0, type::u16<1> c1, bool four)
+	{
+		const vec4f_t a = bc_expand(c0), b = bc_expand(c1);
+		const vec4i_t ia = __builtin_convertvector(a, vec4i_t), ib = __builtin_convertvector(b, vec4i_t);
+		if(four)
+			return { a, b, __builtin_convertvector((2 * ia + ib + 1) / 3, vec4f_t), __builtin_convertvector((ia + 2 * ib + 1) / 3, vec4f_t) };
+		return { a, b, __builtin_convertvector((ia + ib + 1) / 2, vec4f_t), (vec4f_t){} };
+	}
+
+	/* nearest palette entries of the rgb texels x in 0..255, lanes with w zero take the transparent entry 3 */
+	inline __attribute__((__always_inline__)) bc_index bc1_indices(const std::array<bc_lanes,3>& x, bc_lanes w, const std::array<vec4f_t,4>& p, bool four)
+	{
+		bc_lanes best = {};
+		bc_index idx = {};
+		for(int k = 0; k < (four ? 4 : 3); k++)
+		{
+			const bc_lanes d0 = x[0] - p[k][0], d1 = x[1] - p[k][1], d2 = x[2] - p[k][2];
+			const bc_lanes d = d0 * d0 + d1 * d1 + d2 * d2;
+			const bc_index m = k == 0 ? (bc_index){} - 1 : d < best;
+			best = m ? d : best;
+			idx  = m ? k : idx;
+		}
+		return w > 0 ? idx : 3;
+	}
+
+	/* weighted mean and principal axis of the rgb texels x through power iteration on their covariance */
+	inline __attribute__((__always_inline__)) std::pair<vec4f_t, vec4f_t> bc_axis(const std::array<bc_lanes,3>& x, bc_lanes w)
+	{
+		const vecf_t n = std::max<vecf_t>(bc_sum(w), 1);
+		const vec4f_t mu = { bc_sum(x[0] * w) / n, bc_sum(x[1] * w) / n, bc_sum(x[2] * w) / n, 0 };
+		const bc_lanes d0 = (x[0] - mu[0]) * w, d1 = (x[1] - mu[1]) * w, d2 = (x[2] - mu[2]) * w;
+		const vec4f_t c0 = { bc_sum(d0 * d0), bc_sum(d0 * d1), bc_sum(d0 * d2), 0 };
+		const vec4f_t c1 = { c0[1], bc_sum(d1 * d1), bc_sum(d1 * d2), 0 };
+		const vec4f_t c2 = { c0[2], c1[2], bc_sum(d2 * d2), 0 };
+		/* the row of the largest variance has a component along the axis, unlike a sum of rows */
+		vec4f_t v = c0[0] >= c1[1] && c0[0] >= c2[2] ? c0 : c1[1] >= c2[2] ? c1 : c2;
+		for(int i = 0; i < 8; i++)
+		{
+			const vecf_t m = std::max({ std::abs(v[0]), std::abs(v[1]), std::abs(v[2]) });
+			if(m == 0)
+				break;
+			v /= m;
+			v = c0 * v[0] + c1 * v[1] + c2 * v[2];
+		}
+		const vecf_t l = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+		return { mu, l > 0 ? v / std::sqrt(l) : (vec4f_t){} };
+	}
+
+	/* extremes of the weighted texels projected on their principal axis */
+	inline __attribute__((__always_inline__)) std::pair<vec4f_t, vec4f_t> bc1_range_fit(const std::array<bc_lanes,3>& x, bc_lanes w)
+	{
+		const auto [mu, a] = bc_axis(x, w);
+		const bc_lanes t = (x[0] - mu[0]) * a[0] + (x[1] - mu[1]) * a[1] + (x[2] - mu[2]) * a[2];
+		const vecf_t lo = bc_min(w > 0 ? t : std::numeric_limits<vecf_t>::max()), hi = bc_max(w > 0 ? t : -std::numeric_limits<vecf_t>::max());
+		return lo > hi ? std::pair{ mu, mu } : std::pair{ mu + a * hi, mu + a * lo };
+	}
+
+	/* e in 0..255 snapped to the 5 or 6-bit grid of channel c */
+	template<typename V>
+	inline __attribute__((__always_inline__)) V bc_snap(V e, size_t c)
+	{
+		const vecf_t grid = c == 1 ? 63 : 31;
+		e = e > 0 ? e : 0;
+		e = e < 255 ? e : 255;
+		if constexpr(sca<V>)
+			return (vecf_t)(int)(e * (grid / 255) + 0.5f) * (255 / grid);
+		else
+			return __builtin_convertvector(__builtin_convertvector(e * (grid / 255) + 0.5f, bc_index), V) * (255 / grid);
+	}
+
+	/* least squares endpoints of channel c for the weights aa = sum a^2, bb = sum b^2, ab = sum a b of the two endpoints,
+	   the reciprocal of their determinant and the weighted texel sums ax and bx, snapped to the 565 grid */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::pair<V, V> bc_endpoints(V aa, V bb, V ab, V rdet, V ax, V bx, size_t c)
+	{
+		return { bc_snap((ax * bb - bx * ab) * rdet, c), bc_snap((bx * aa - ax * ab) * rdet, c) };
+	}
+
+	/* the ordered splits of 16 texels into runs [0, i), [i, j), [j, k) and [k, 16) taking 1, 2/3, 1/3 and 0 of the first
+	   endpoint, packed i | j << 8 | k << 16, with the reciprocal determinant of their least squares system. splits
+	   with every texel in one run have no solution and are left out, the last packet repeats the final split */
+	struct bc_split_table
+	{
+		static constexpr size_t size = 976;
+		std::array<type::i32<1>,size> ijk;
+		std::array<vecf_t,size> rdet;
+	};
+
+	/* sums a a, b b and a b of the endpoint weights of the split packed in ijk */
+	template<typename V, typename I>
+	inline constexpr __attribute__((__always_inline__)) std::array<V,3> bc_split_weights(I ijk)
+	{
+		V i, j, k;
+		if constexpr(sca<V>)
+			i = ijk & 255, j = ijk >> 8 & 255, k = ijk >> 16;
+		else
+			i = __builtin_convertvector(ijk & 255, V), j = __builtin_convertvector(ijk >> 8 & 255, V), k = __builtin_convertvector(ijk >> 16, V);
+		return { i + (j - i) * (4.f / 9) + (k - j) * (1.f / 9), (16.f - k) + (j - i) * (1.f / 9) + (k - j) * (4.f / 9), (k - i) * (2.f / 9) };
+	}
+
+	static constexpr bc_split_table bc_splits = []()
+	{
+		bc_split_table t = {};
+		size_t n = 0;
+		for(int i = 0; i <= 16; i++)
+			for(int j = i; j <= 16; j++)
+				for(int k = j; k <= 16; k++)
+				{
+					const auto [aa, bb, ab] = bc_split_weights<vecf_t>(i | j << 8 | k << 16);
+					if(i == 16 || j - i == 16 || k - j == 16 || k == 0)
+						continue;
+					t.ijk[n] = i | j << 8 | k << 16;
+					t.rdet[n++] = 1 / (aa * bb - ab * ab);
+				}
+		for(; n < bc_split_table::size; n++)
+		{
+			t.ijk[n] = t.ijk[n - 1];
+			t.rdet[n] = t.rdet[n - 1];
+		}
+		return t;
+	}();
+
+	/* least squares endpoints of the best split of the texels ordered along their principal axis, the candidates are
+	   snapped to the 565 grid before measuring their error, one split per lane */
+	inline __attribute__((__always_inline__)) std::pair<vec4f_t, vec4f_t> bc1_cluster_fit(const std::array<bc_lanes,3>& x)
+	{
+		const auto [mu, a] = bc_axis(x, (bc_lanes){} + 1);
+		const bc_lanes t = (x[0] - mu[0]) * a[0] + (x[1] - mu[1]) * a[1] + (x[2] - mu[2]) * a[2];
+
+		/* texels by decreasing projection */
+		std::array<int,16> order;
+		for(int i = 0; i < 16; i++)
+		{
+			int j = i;
+			for(; j > 0 && t[order[j - 1]] < t[i]; j--)
+				order[j] = order[j - 1];
+			order[j] = i;
+		}
+
+		/* per channel prefix sums, sums of the first 0 to 15 texels and then of all 16 */
+		std::array<bc_lanes,3> lo, hi;
+		for(size_t c = 0; c < 3; c++)
+		{
+			vecf_t sum = 0;
+			for(int i = 0; i < 16; i++)
+			{
+				lo[c][i] = sum;
+				sum += x[c][order[i]];
+			}
+			hi[c] = (bc_lanes){} + sum;
+		}
+
+		bc_lanes best = (bc_lanes){} + std::numeric_limits<vecf_t>::max();
+		bc_index arg = {};
+		for(size_t n = 0; n < bc_split_table::size; n += 16)
+		{
+			const bc_index ijk = loadu<bc_index>(&bc_splits.ijk[n]);
+			const auto [aa, bb, ab] = bc_split_weights<bc_lanes>(ijk);
+			const bc_lanes rdet = loadu<bc_lanes>(&bc_splits.rdet[n]);
+			/* squared error less the constant sum of the squared texels */
+			bc_lanes err = {};
+			for(size_t c = 0; c < 3; c++)
+			{
+				const bc_lanes si = __builtin_shuffle(lo[c], hi[c], ijk & 255), sj = __builtin_shuffle(lo[c], hi[c], ijk >> 8 & 255);
+				const bc_lanes sk = __builtin_shuffle(lo[c], hi[c], ijk >> 16);
+				const bc_lanes ax = (si + sj + sk) * (1.f / 3), bx = hi[c] - ax;
+				const auto [e0, e1] = bc_endpoints(aa, bb, ab, rdet, ax, bx, c);
+				err += e0 * e0 * aa + e1 * e1 * bb + 2 * (e0 * e1 * ab - e0 * ax - e1 * bx);
+			}
+			const bc_index m = err < best;
+			best = m ? err : best;
+			arg  = m ? ijk : arg;
+		}
+
+		/* first lane of the least error */
+		const vecf_t least = bc_min(best);
+		size_t l = 0;
+		while(l < 15 && best[l] != least)
+			l++;
+		const type::i32<1> ijk = arg[l];
+		const auto [aa, bb, ab] = bc_split_weights<vecf_t>(ijk);
+		vec4f_t e0 = {}, e1 = {};
+		for(size_t c = 0; c < 3; c++)
+		{
+			const auto at = [&](int i) { return i < 16 ? lo[c][i] : hi[c][0]; };
+			const vecf_t ax = (at(ijk & 255) + at(ijk >> 8 & 255) + at(ijk >> 16)) * (1.f / 3), bx = hi[c][0] - ax;
+			std::tie(e0[c], e1[c]) = bc_endpoints(aa, bb, ab, 1 / (aa * bb - ab * ab), ax, bx, c);
+		}
+		return { e0, e1 };
+	}
+
+	/* BC1 block of the rgb texels x in 0..255, lanes with w zero are transparent and select three colors which are
+	   always range fit */
+	template<bc_fit F>
+	inline __attribute__((__always_inline__)) bc1_block bc1_encode(const std::array<bc_lanes,3>& x, bc_lanes w, bool four)
+	{
+		const auto [e0, e1] = F == bc_fit::cluster && four ? bc1_cluster_fit(x) : bc1_range_fit(x, w);
+		bc1_block b = { bc_quantize(e0), bc_quantize(e1), 0 };
+		/* equal endpoints of an opaque block leave every index at c0 */
+		if(four ? b.c0 < b.c1 : b.c0 > b.c1)
+			std::swap(b.c0, b.c1);
+		if(!four || b.c0 != b.c1)
+			b.idx = (type::u32<1>)bc_pack<2>(bc1_indices(x, w, bc1_palette(b.c0, b.c1, four), four));
+		return b;
+	}
+
+	/* BC4 palette */
+	inline __attribute__((__always_inline__)) std::array<vecf_t,8> bc4_palette(int a0, int a1)
+	{
+		std::array<vecf_t,8> p = { (vecf_t)a0, (vecf_t)a1, 0, 0, 0, 0, 0, 255 };
+		if(a0 > a1)
+			for(int k = 2; k < 8; k++)
+				p[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+		else
+			for(int k = 2; k < 6; k++)
+				p[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+		return p;
+	}
+
+	/* BC4 block of the values v in 0..255 between the endpoints a0 and a1 and its summed squared error */
+	inline __attribute__((__always_inline__)) std::pair<bc4_block, vecf_t> bc4_encode(bc_lanes v, int a0, int a1)
+	{
+		const std::array<vecf_t,8> p = bc4_palette(a0, a1);
+		bc_lanes best = (v - p[0]) * (v - p[0]);
+		bc_index idx = {};
+		for(int k = 1; k < 8; k++)
+		{
+			const bc_lanes d = (v - p[k]) * (v - p[k]);
+			const bc_index m = d < best;
+			best = m ? d : best;
+			idx  = m ? k : idx;
+		}
+		const type::u64<1> bits = bc_pack<3>(idx);
+		bc4_block b = { (type::u8<1>)a0, (type::u8<1>)a1, {} };
+		for(int i = 0; i < 6; i++)
+			b.idx[i] = (type::u8<1>)(bits >> (8 * i));
+		return { b, bc_sum(best) };
+	}
+
+	/* BC4 block of the values v in [0,1], eight values between the extremes and with cluster also six values between
+	   the extremes short of 0 and 255 when that has the lower error */
+	template<bc_fit F>
+	inline __attribute__((__always_inline__)) bc4_block bc4_encode(bc_lanes v)
+	{
+		v = v > 0 ? v : 0;
+		v = v < 1 ? v : 1;
+		v = __builtin_convertvector(__builtin_convertvector(v * 255 + 0.5f, bc_index), bc_lanes);
+		auto r = bc4_encode(v, (int)bc_max(v), (int)bc_min(v));
+		if constexpr(F == bc_fit::cluster)
+		{
+			const int lo = (int)bc_min(v > 0 ? v : 255), hi = (int)bc_max(v < 255 ? v : 0);
+			if(lo <= hi)
+			{
+				const auto s = bc4_encode(v, lo, hi);
+				if(s.second < r.second)
+					r = s;
+			}
+		}
+		return r.first;
+	}
+
+	/* values of the BC4 block in 0..255 */
+	inline __attribute__((__always_inline__)) bc_lanes bc4_decode(const bc4_block& b)
+	{
+		type::u64<1> bits = 0;
+		for(int i = 0; i < 6; i++)
+			bits |= (type::u64<1>)b.idx[i] << (8 * i);
+		const std::array<vecf_t,8> p = bc4_palette(b.a0, b.a1);
+		const bc_index idx = bc_unpack<3>(bits);
+		bc_lanes v = {};
+		for(int k = 0; k < 8; k++)
+			v = idx == k ? p[k] : v;
+		return v;
+	}
+
+	/* rgba texels of the BC1 block in 0..255 */
+	inline __attribute__((__always_inline__)) std::array<bc_lanes,4> bc1_decode(const bc1_block& b, bool four)
+	{
+		const std::array<vec4f_t,4> p = bc1_palette(b.c0, b.c1, four);
+		const bc_index idx = bc_unpack<2>(b.idx);
+		std::array<bc_lanes,4> c = {};
+		for(int k = 0; k < 4; k++)
+			for(size_t i = 0; i < 4; i++)
+				c[i] = idx == k ? p[k][i] : c[i];
+		return c;
+	}
+
+	/* 16 texels of block k of the width x height image in [0,1], edges past the image repeat the last row and column */
+	template<fmt format>
+	inline __attribute__((__always_inline__)) std::array<bc_lanes,4> bc_load(const pixel<format>* src, size_t width, size_t height, size_t k)
+	{
+		const size_t bw = (width + 3) / 4, x = k % bw * 4, y = k / bw * 4;
+		pixel<format> t[16];
+		for(size_t i = 0; i < 16; i++)
+			t[i] = src[std::min(y + i / 4, height - 1) * width + std::min(x + i % 4, width - 1)];
+		std::array<bc_lanes,4> c = unpack<format, vecf_t, 16>(t);
+		for(bc_lanes& v : c)
+		{
+			v = v > 0 ? v : 0;
+			v = v < 1 ? v : 1;
+		}
+		return c;
+	}
+
+	/* texels c in 0..255 into block k of the width x height image, the part past the image is dropped */
+	template<fmt format>
+	inline __attribute__((__always_inline__)) void bc_store(std::array<bc_lanes,4> c, pixel<format>* dst, size_t width, size_t height, size_t k)
+	{
+		const size_t bw = (width + 3) / 4, x = k % bw * 4, y = k / bw * 4;
+		pixel<format> t[16];
+		for(bc_lanes& v : c)
+			v /= 255;
+		pack<format, vecf_t, 16>(c, t);
+		for(size_t i = 0; i < 16; i++)
+			if(y + i / 4 < height && x + i % 4 < width)
+				dst[(y + i / 4) * width + x + i % 4] = t[i];
+	}
+
+	/* f(first, last) built for the active tier over the blocks [0, n) in chunks of 64 blocks on threads threads or the
+	   hardware concurrency when 0, see parallel_for */
+	template<typename F>
+	inline void bc_parallel(size_t n, size_t threads, F&& f)
+	{
+		parallel_for({ threads, 64 }, n, 0, [&](size_t first, size_t last) { simd_dispatch([&] { f(first, last); return last - first; }); });
+	}
+
+	/* number of 4x4 blocks covering a width x height image */
+	inline size_t bc_blocks(size_t width, size_t height) { return (width + 3) / 4 * ((height + 3) / 4); }
+
+	/* BC1 compression of the row major width x height image into its row major blocks, a texel with alpha below one
+	   half makes its block use three colors and transparent black. returns the number of blocks written, 0 when src
+	   or dst are too small */
+	template<fmt format, bc_fit F = bc_fit::range>
+	size_t encode_bc1(std::span<const pixel<format>> src, size_t width, size_t height, std::span<bc1_block> dst, size_t threads = 1)
+	{
+		const size_t n = bc_blocks(width, height);
+		if(width == 0 || height == 0 || src.size() < width * height || dst.size() < n)
+			return 0;
+		bc_parallel(n, threads, [&](size_t first, size_t last)
+		{
+			for(size_t k = first; k < last; k++)
+			{
+				const std::array<bc_lanes,4> c = bc_load<format>(src.data(), width, height, k);
+				const bc_lanes w = c[col::a] >= 0.5f ? (bc_lanes){} + 1 : (bc_lanes){};
+				dst[k] = bc1_encode<F>({ c[0] * 255, c[1] * 255, c[2] * 255 }, w, bc_min(w) > 0);
+			}
+		});
+		return n;
+	}
+
+	/* BC3 compression of the row major width x height image into its row major blocks, returns the number of blocks
+	   written, 0 when src or dst are too small */
+	template<fmt format, bc_fit F = bc_fit::range>
+	size_t encode_bc3(std::span<const pixel<format>> src, size_t width, size_t height, std::span<bc3_block> dst, size_t threads = 1)
+	{
+		const size_t n = bc_blocks(width, height);
+		if(width == 0 || height == 0 || src.size() < width * height || dst.size() < n)
+			return 0;
+		bc_parallel(n, threads, [&](size_t first, size_t last)
+		{
+			for(size_t k = first; k < last; k++)
+			{
+				const std::array<bc_lanes,4> c = bc_load<format>(src.data(), width, height, k);
+				dst[k] = { bc4_encode<F>(c[col::a]), bc1_encode<F>({ c[0] * 255, c[1] * 255, c[2] * 255 }, (bc_lanes){} + 1, true) };
+			}
+		});
+		return n;
+	}
+
+	/* BC1 decompression of the row major blocks into the row major width x height image, returns the number of blocks
+	   read, 0 when src or dst are too small */
+	template<fmt format>
+	size_t decode_bc1(std::span<const bc1_block> src, size_t width, size_t height, std::span<pixel<format>> dst, size_t threads = 1)
+	{
+		const size_t n = bc_blocks(width, height);
+		if(width == 0 || height == 0 || src.size() < n || dst.size() < width * height)
+			return 0;
+		bc_parallel(n, threads, [&](size_t first, size_t last)
+		{
+			for(size_t k = first; k < last; k++)
+				bc_store<format>(bc1_decode(src[k], src[k].c0 > src[k].c1), dst.data(), width, height, k);
+		});
+		return n;
+	}
+
+	/* BC3 decompression of the row major blocks into the row major width x height image, returns the number of blocks
+	   read, 0 when src or dst are too small */
+	template<fmt format>
+	size_t decode_bc3(std::span<const bc3_block> src, size_t width, size_t height, std::span<pixel<format>> dst, size_t threads = 1)
+	{
+		const size_t n = bc_blocks(width, height);
+		if(width == 0 || height == 0 || src.size() < n || dst.size() < width * height)
+			return 0;
+		bc_parallel(n, threads, [&](size_t first, size_t last)
+		{
+			for(size_t k = first; k < last; k++)
+			{
+				std::array<bc_lanes,4> c = bc1_decode(src[k].color, true);
+				c[col::a] = bc4_decode(src[k].alpha);
+				bc_store<format>(c, dst.data(), width, height, k);
+			}
+		});
+		return n;
+	}
+};
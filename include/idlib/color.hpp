@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <span>
+
+#include <idlib/math.hpp>
+
+namespace id::math::type::col
+{
+	/* floating point color format with one 32 or 64-bit float per component */
+	constexpr bool floating(const fmt& format)
+	{
+		return std::all_of(format.second.begin(), format.second.end(), [](idx8<1> n) { return n == 0 || n == 32 || n == 64; });
+	}
+
+	/* pixel storage type of a color format, packed bitfield or floating point vector */
+	template<fmt format>
+	using pixel = std::conditional_t<floating(format),
+	                                 std::conditional_t<*std::max_element(format.second.begin(), format.second.end()) == 64, vec4d_t, vec4f_t>,
+	                                 bitfield_color<format>>;
+
+	/* pixels converted per kernel iteration, one REG byte float register of channels and at least 8 */
+	template<size_t REG = simd_native_bytes>
+	static constexpr size_t batch = std::max<size_t>(8, lanes<vecf_t,REG>);
+
+	/* intermediate component type, double only when either side of the conversion is double */
+	template<fmt src, fmt dst>
+	using calc = std::conditional_t<std::is_same_v<pixel<src>, vec4d_t> || std::is_same_v<pixel<dst>, vec4d_t>, vecd_t, vecf_t>;
+
+	/* round half away from zero of non-negative lanes, lroundf semantics without the libm call */
+	template<sca T, size_t N>
+	inline __attribute__((__always_inline__)) vector_aligned<i32<1>,N> unorm_round(vector_aligned<T,N> v)
+	{
+		vector_aligned<i32<1>,N> i = __builtin_convertvector(v, vector_aligned<i32<1>,N>);
+		return i - __builtin_convertvector(v - __builtin_convertvector(i, vector_aligned<T,N>) >= (T)0.5, vector_aligned<i32<1>,N>);
+	}
+
+	/* every S-th lane of v starting at lane L */
+	template<size_t L, size_t S, typename V, size_t... K>
+	inline __attribute__((__always_inline__)) auto stride(V v, std::index_sequence<K...>) { return __builtin_shufflevector(v, v, (L + S * K)...); }
+
+	/* decode N pixels into RGBA ordered planes of normalized components */
+	template<fmt format, sca T, size_t N = batch<>>
+	inline __attribute__((__always_inline__)) std::array<vector_aligned<T,N>,4> unpack(const pixel<format>* src)
+	{
+		using P = pixel<format>;
+		std::array<vector_aligned<T,N>,4> dst;
+
+		if constexpr(floating(format))
+		{
+			using S = std::conditional_t<std::is_same_v<P, vec4d_t>, vecd_t, vecf_t>;
+			vector_aligned<S,4 * N> v;
+			std::memcpy(&v, src, sizeof(v));
+			[&]<size_t... C>(std::index_sequence<C...>)
+			{
+				((dst[C] = format.second[format.first[C]] == 0 ? (vector_aligned<T,N>){} + (T)(C == col::a)
+				         : __builtin_convertvector(stride<format.first[C] % 4, 4>(v, std::make_index_sequence<N>{}), vector_aligned<T,N>)), ...);
+			}(std::make_index_sequence<4>{});
+		}
+		else
+		{
+			using S = typename P::storage_type;
+			vector_aligned<S,N> w;
+			std::memcpy(&w, src, sizeof(w));
+#pragma GCC unroll 4
+			for(size_t c = 0; c <= col::a; c++)
+			{
+				const size_t k = P::perm[c];
+				if(P::bits[k] == 0)
+				{
+					dst[c] = (vector_aligned<T,N>){} + (T)(c == col::a);
+					continue;
+				}
+				vector_aligned<i32<1>,N> i = __builtin_convertvector((w & P::mask[k]) >> P::shift[k], vector_aligned<i32<1>,N>);
+				dst[c] = __builtin_convertvector(i, vector_aligned<T,N>) / (T)((1 << P::bits[k]) - 1);
+			}
+		}
+		return dst;
+	}
+
+	/* encode RGBA ordered planes of normalized components into N pixels, saturating to [0,1] for packed formats */
+	template<fmt format, sca T, size_t N = batch<>>
+	inline __attribute__((__always_inline__)) void pack(const std::array<vector_aligned<T,N>,4>& src, pixel<format>* dst)
+	{
+		using P = pixel<format>;
+
+		if constexpr(floating(format))
+		{
+			using S = std::conditional_t<std::is_same_v<P, vec4d_t>, vecd_t, vecf_t>;
+			/* inverse permutation, lane l of a pixel holds channel inv[l] */
+			static constexpr std::array<size_t,4> inv = [](){ std::array<size_t,4> i{}; for(size_t c = 0; c < 4; c++) i[format.first[c] % 4] = c; return i; }();
+			vector_aligned<S,N> r = __builtin_convertvector(src[col::r], vector_aligned<S,N>);
+			vector_aligned<S,N> g = __builtin_convertvector(src[col::g], vector_aligned<S,N>);
+			vector_aligned<S,N> b = __builtin_convertvector(src[col::b], vector_aligned<S,N>);
+			vector_aligned<S,N> a = __builtin_convertvector(src[col::a], vector_aligned<S,N>);
+			vector_aligned<S,4 * N> v = [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				vector_aligned<S,2 * N> lo = __builtin_shufflevector(r, g, I..., (I + N)...);
+				vector_aligned<S,2 * N> hi = __builtin_shufflevector(b, a, I..., (I + N)...);
+				return [&]<size_t... L>(std::index_sequence<L...>)
+				{
+					return __builtin_shufflevector(lo, hi, (inv[L % 4] * N + L / 4)...);
+				}(std::make_index_sequence<4 * N>{});
+			}(std::make_index_sequence<N>{});
+			std::memcpy((void*)dst, &v, sizeof(v));
+		}
+		else
+		{
+			using S = typename P::storage_type;
+			vector_aligned<S,N> w = {};
+#pragma GCC unroll 4
+			for(size_t c = 0; c <= col::a; c++)
+			{
+				const size_t k = P::perm[c];
+				if(P::bits[k] == 0)
+					continue;
+				vector_aligned<T,N> v = src[c];
+				v = v > 0 ? v : 0;
+				v = v < 1 ? v : 1;
+				vector_aligned<S,N> q = __builtin_convertvector(unorm_round<T,N>(v * (T)((1 << P::bits[k]) - 1)), vector_aligned<S,N>);
+				w |= (q << P::shift[k]) & P::mask[k];
+			}
+			std::memcpy((void*)dst, &w, sizeof(w));
+		}
+	}
+
+	/* { mul, add, shift } with (v * mul + add) >> shift equal to unorm_table<FROM, TO>[v] for every v in 32-bit lanes,
+	   searched and checked against the table at compile time, mul is 0 when no shift below 32 has one */
+	template<size_t FROM, size_t TO>
+	static constexpr std::array<type::u32<1>,3> unorm_muladd = []()
+	{
+		const type::u64<1> d = ((type::u64<1>)1 << FROM) - 1, m = ((type::u64<1>)1 << TO) - 1;
+		for(type::u64<1> sh = 0; sh < 32; sh++)
+			for(type::u64<1> mul = (m << sh) / d; mul <= (m << sh) / d + 1; mul++)
+			{
+				/* the adds that keep every v within its rounded value form an interval */
+				type::i64<1> lo = 0, hi = INT64_MAX;
+				for(type::u64<1> v = 0; v <= d; v++)
+				{
+					const type::u64<1> t = unorm_table<FROM,TO>[v];
+					lo = std::max<type::i64<1>>(lo, (type::i64<1>)(t << sh) - (type::i64<1>)(v * mul));
+					hi = std::min<type::i64<1>>(hi, (type::i64<1>)((t + 1) << sh) - (type::i64<1>)(v * mul));
+				}
+				if(lo < hi && d * mul + lo <= UINT32_MAX)
+					return std::array<type::u32<1>,3>{ (type::u32<1>)mul, (type::u32<1>)lo, (type::u32<1>)sh };
+			}
+		return std::array<type::u32<1>,3>{};
+	}();
+
+	/* packed formats of at most 32 bits and source channels of at most 10 bits convert in integer lanes */
+	template<fmt src, fmt dst>
+	static constexpr bool integer_convertible = []()
+	{
+		const auto total = [](const fmt& f) { return std::accumulate(f.second.begin(), f.second.end(), 0); };
+		return !floating(src) && !floating(dst) && total(src) <= 32 && total(dst) <= 32 && *std::max_element(src.second.begin(), src.second.end()) <= 10;
+	}();
+
+	/* channel C of 32-bit source words x at its place in the destination word, rescaled through unorm_muladd */
+	template<fmt src_format, fmt dst_format, size_t C, size_t N>
+	inline __attribute__((__always_inline__)) vector_aligned<type::u32<1>,N> rescale_channel(vector_aligned<type::u32<1>,N> x)
+	{
+		using S = bitfield_color<src_format>;
+		using D = bitfield_color<dst_format>;
+		using U = vector_aligned<type::u32<1>,N>;
+		constexpr size_t ks = S::perm[C], kd = D::perm[C], from = S::bits[ks], to = D::bits[kd];
+		if constexpr(to == 0)
+			return U{};
+		else if constexpr(from == 0)
+			return U{} + (C == col::a ? (type::u32<1>)D::mask[kd] : 0);
+		else
+		{
+			U q = (x & (type::u32<1>)S::mask[ks]) >> S::shift[ks];
+			if constexpr(from != to)
+			{
+				constexpr std::array<type::u32<1>,3> k = unorm_muladd<from, to>;
+				static_assert(k[0] != 0, "no 32-bit multiply add rescale");
+				q = (q * k[0] + k[1]) >> k[2];
+			}
+			return q << D::shift[kd];
+		}
+	}
+
+	/* N packed pixels converted to another packed format with integer multiply adds instead of float divides */
+	template<fmt src_format, fmt dst_format, size_t N = batch<>>
+	inline __attribute__((__always_inline__)) void rescale(const pixel<src_format>* src, pixel<dst_format>* dst)
+	{
+		using S = typename bitfield_color<src_format>::storage_type;
+		using D = typename bitfield_color<dst_format>::storage_type;
+		using U = vector_aligned<type::u32<1>,N>;
+		vector_aligned<S,N> w;
+		std::memcpy(&w, src, sizeof(w));
+		const U x = __builtin_convertvector(w, U);
+		U v = {};
+		[&]<size_t... C>(std::index_sequence<C...>) { ((v |= rescale_channel<src_format, dst_format, C, N>(x)), ...); }(std::make_index_sequence<4>{});
+		if constexpr(sizeof(D) < sizeof(type::u32<1>))
+		{
+			const vector_aligned<D,N> d = narrow<D, type::u32<1>, N>(v);
+			std::memcpy((void*)dst, &d, sizeof(d));
+		}
+		else
+			std::memcpy((void*)dst, &v, sizeof(v));
+	}
+
+	/* convert a span of pixels between two color formats, returns the number of converted pixels */
+	template<fmt src_format, fmt dst_format>
+	size_t convert(std::span<const pixel<src_format>> src, std::span<pixel<dst_format>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			using T = calc<src_format, dst_format>;
+			static constexpr size_t B = batch<REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			size_t i = 0;
+
+			auto step = [](const pixel<src_format>* s, pixel<dst_format>* d)
+			{
+				if constexpr(integer_convertible<src_format, dst_format>)
+					rescale<src_format, dst_format, B>(s, d);
+				else
+					pack<dst_format, T, B>(unpack<src_format, T, B>(s), d);
+			};
+
+			for(; i + B <= len; i += B)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				pixel<src_format> in[B] = {};
+				pixel<dst_format> out[B];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* one pixel converted like convert, usable in constant expressions */
+	template<fmt dst_format, fmt src_format>
+	constexpr pixel<dst_format> cast(const bitfield_color<src_format>& c)
+	{
+		using S = bitfield_color<src_format>;
+		if constexpr(floating(dst_format))
+		{
+			using P = pixel<dst_format>;
+			using T = std::remove_cvref_t<decltype(std::declval<P>()[0])>;
+			const auto norm = [&](size_t i) -> T
+			{
+				const size_t n = S::bits[S::perm[i]];
+				return n == 0 ? (T)(i == col::a) : (T)c.get(i) / (T)((1 << n) - 1);
+			};
+			/* lane l of a pixel holds channel inv[l] */
+			constexpr std::array<size_t,4> inv = [](){ std::array<size_t,4> i{}; for(size_t k = 0; k < 4; k++) i[dst_format.first[k] % 4] = k; return i; }();
+			return (P){ norm(inv[0]), norm(inv[1]), norm(inv[2]), norm(inv[3]) };
+		}
+		else
+		{
+			using D = bitfield_color<dst_format>;
+			D d;
+			for(size_t i = 0; i <= col::a; i++)
+			{
+				const size_t from = S::bits[S::perm[i]], to = D::bits[D::perm[i]];
+				if(to != 0)
+					d.set(i, from == 0 ? (i == col::a ? ((type::u64<1>)1 << to) - 1 : 0) : unorm_rescale(c.get(i), from, to));
+			}
+			return d;
+		}
+	}
+
+	/* palette table converted at compile time, e.g. static constexpr auto lut = palette<rgba8888>(colors) for lookup */
+	template<fmt dst_format, fmt src_format, size_t N>
+	constexpr std::array<pixel<dst_format>,N> palette(const std::array<bitfield_color<src_format>,N>& src)
+	{
+		std::array<pixel<dst_format>,N> dst{};
+		for(size_t i = 0; i < N; i++)
+			dst[i] = cast<dst_format>(src[i]);
+		return dst;
+	}
+
+	/* dst[i] = table[index[i]] of indexed texels, the table covers every index, returns the number of pixels. a plain
+	   loop, the AVX2 and AVX-512 gathers of 32-bit pixels measured no faster than its scalar loads */
+	template<fmt format, size_t N>
+	size_t lookup(std::span<const idx8<1>> index, const std::array<pixel<format>,N>& table, std::span<pixel<format>> dst)
+	{
+		static_assert(N >= 256, "a table entry for every 8-bit index");
+		const size_t len = std::min(index.size(), dst.size());
+		for(size_t i = 0; i < len; i++)
+			dst[i] = table[index[i]];
+		return len;
+	}
+};
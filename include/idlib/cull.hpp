@@ -0,0 +1,131 @@
+#pragma once
+
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+
+namespace id::math::type
+{
+	/* plane { n, w } holding the points p with n . p + w = 0, the side n points to is the front */
+	template<sca T>
+	using plane = vec<T,4>;
+
+	using planef_t = plane<vecf_t>;
+	using planed_t = plane<vecd_t>;
+
+	/* component type of the elements of a soa or aosoa container */
+	template<typename C>
+	using scalar_of = std::remove_cvref_t<decltype(std::declval<typename C::value_type>()[0])>;
+
+	/* sides of a plane a volume reaches, cross when it reaches both */
+	enum class side : u8<1> { front = 1, back = 2, cross = 3 };
+
+	/* BoxOnPlaneSide, the sides of p the box [lo, hi] reaches through its center distance and projected half extent */
+	template<sca T>
+	inline side box_on_plane_side(const vec<T,3>& lo, const vec<T,3>& hi, const plane<T>& p)
+	{
+		vec<T,4> c = { (lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2, 1 };
+		vec<T,4> e = { (hi[0] - lo[0]) / 2, (hi[1] - lo[1]) / 2, (hi[2] - lo[2]) / 2, 0 };
+		vec<T,4> a = p < 0 ? -p : p, dc = p * c, de = a * e;
+		T d = (dc[0] + dc[1]) + (dc[2] + dc[3]), r = (de[0] + de[1]) + de[2];
+		return (side)((d + r >= 0 ? 1 : 0) | (d - r < 0 ? 2 : 0));
+	}
+
+	/* visible and intersecting lane masks of W volumes with centers c against every plane, radius(p) is the per lane
+	   projected radius of the volumes onto the normal of p. a volume is visible unless it is entirely behind one
+	   plane and intersecting when visible and reaching behind at least one */
+	template<sca T, typename V, typename R>
+	inline __attribute__((__always_inline__)) std::pair<lane_mask<V>, lane_mask<V>> cull_planes(const std::array<V,3>& c, std::span<const plane<T>> planes, R&& radius)
+	{
+		lane_mask<V> out = {}, straddle = {};
+		for(const plane<T>& p : planes)
+		{
+			V d = c[0] * p[0] + c[1] * p[1] + c[2] * p[2] + p[3], r = radius(p);
+			out      |= d + r < 0;
+			straddle |= d - r < 0;
+		}
+		return { ~out, ~out & straddle };
+	}
+
+	/* runs the per packet masks f(k) over n volumes of W lanes into the bitmasks visible and intersecting,
+	   bit i of word i / 64 is volume i, returns the number of volumes classified */
+	template<size_t W, typename F>
+	inline size_t cull_bits(size_t n, std::span<u64<1>> visible, std::span<u64<1>> intersecting, F&& f)
+	{
+		static_assert(64 % W == 0, "whole packets per word");
+		const size_t len = std::min({ n, visible.size() * 64, intersecting.size() * 64 });
+		for(size_t w = 0; w * 64 < len; w++)
+		{
+			u64<1> v = 0, x = 0;
+			for(size_t k = w * 64 / W; k < (w + 1) * 64 / W && k * W < len; k++)
+			{
+				auto [vm, xm] = f(k);
+				v |= lane_bits(vm) << (k * W % 64);
+				x |= lane_bits(xm) << (k * W % 64);
+			}
+			/* lanes past n hold zero volumes */
+			const u64<1> keep = len - w * 64 >= 64 ? ~(u64<1>)0 : ((u64<1>)1 << (len - w * 64)) - 1;
+			visible[w] = v & keep;
+			intersecting[w] = x & keep;
+		}
+		return len;
+	}
+
+	/* frustum culling of the axis aligned boxes [lo, hi] held in equally sized soa or aosoa containers, e.g. against
+	   the six inward facing planes of a view. with a single plane visible is the front and intersecting the cross
+	   side of BoxOnPlaneSide. returns the number of boxes classified */
+	template<typename C, sca T = scalar_of<C>>
+	size_t cull_boxes(const C& lo, const C& hi, std::span<const plane<std::type_identity_t<T>>> planes, std::span<u64<1>> visible, std::span<u64<1>> intersecting)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			return cull_bits<sizeof(V) / sizeof(T)>(lo.size(), visible, intersecting, [&](size_t k)
+			{
+				const auto a = lo.load(k), b = hi.load(k);
+				const std::array<V,3> c = { (a[0] + b[0]) * (T)0.5, (a[1] + b[1]) * (T)0.5, (a[2] + b[2]) * (T)0.5 };
+				const std::array<V,3> e = { (b[0] - a[0]) * (T)0.5, (b[1] - a[1]) * (T)0.5, (b[2] - a[2]) * (T)0.5 };
+				return cull_planes<T>(c, planes, [&](const plane<T>& p) { return e[0] * std::abs(p[0]) + e[1] * std::abs(p[1]) + e[2] * std::abs(p[2]); });
+			});
+		});
+	}
+
+	/* frustum culling of spheres { x, y, z, radius } held in a 4-component soa or aosoa container */
+	template<typename C, sca T = scalar_of<C>>
+	size_t cull_spheres(const C& spheres, std::span<const plane<std::type_identity_t<T>>> planes, std::span<u64<1>> visible, std::span<u64<1>> intersecting)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			return cull_bits<sizeof(V) / sizeof(T)>(spheres.size(), visible, intersecting, [&](size_t k)
+			{
+				const auto s = spheres.load(k);
+				return cull_planes<T>(std::array<V,3>{ s[0], s[1], s[2] }, planes, [&](const plane<T>&) { return s[3]; });
+			});
+		});
+	}
+
+	/* frustum culling of oriented boxes, center, half extents along the unit axes x, y and z, all held in equally
+	   sized soa or aosoa containers */
+	template<typename C, sca T = scalar_of<C>>
+	size_t cull_obbs(const C& center, const C& extent, const C& x, const C& y, const C& z,
+	                 std::span<const plane<std::type_identity_t<T>>> planes, std::span<u64<1>> visible, std::span<u64<1>> intersecting)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			return cull_bits<sizeof(V) / sizeof(T)>(center.size(), visible, intersecting, [&](size_t k)
+			{
+				const auto c = center.load(k), e = extent.load(k), ax = x.load(k), ay = y.load(k), az = z.load(k);
+				return cull_planes<T>(c, planes, [&](const plane<T>& p)
+				{
+					V dx = ax[0] * p[0] + ax[1] * p[1] + ax[2] * p[2];
+					V dy = ay[0] * p[0] + ay[1] * p[1] + ay[2] * p[2];
+					V dz = az[0] * p[0] + az[1] * p[1] + az[2] * p[2];
+					return e[0] * (dx < 0 ? -dx : dx) + e[1] * (dy < 0 ? -dy : dy) + e[2] * (dz < 0 ? -dz : dz);
+				});
+			});
+		});
+	}
+};
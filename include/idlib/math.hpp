@@ -2,11 +2,13 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <cstdint>
 #include <cstddef>
 #include <cstdbool>
 #include <ctime>
 #include <cmath>
+#include <algorithm>
 #include <array>
 #include <utility>
 #include <numeric>
@@ -15,6 +17,9 @@
 #include <iostream>
 #include <string>
 #include <bit>
+#include <limits>
+#include <span>
+#include <source_location>
 #include <type_traits>
 #include <experimental/simd>
 
@@ -27,6 +32,8 @@
 #include <GL/glu.h>
 #include <GL/glcorearb.h>
 
+#include <idlib/profile.hpp>
+
 namespace stdx = std::experimental;
 using namespace stdx::parallelism_v2;
 
@@ -55,8 +62,15 @@ using element_aligned = std::array<T,ROWS>;
 template<sca T, size_t ROWS = 4, size_t N = std::bit_ceil(ROWS)>
 using vector_aligned __attribute__((vector_size(N * sizeof(T)))) = T;
 
+/* storage of non power of two vectors, tightly packed element_aligned arrays or padded vector_aligned registers */
+enum class storage { packed, padded };
+
+template<sca T, size_t ROWS, storage S = storage::packed>
+using vec = std::conditional_t<power_of_two<ROWS> || S == storage::padded, vector_aligned<T, ROWS>, element_aligned<T,ROWS>>;
+
+/* opt-in padded vector, the lanes past ROWS hold the NET value of the load that filled them */
 template<sca T, size_t ROWS>
-using vec = std::conditional_t<power_of_two<ROWS>, vector_aligned<T, ROWS>, element_aligned<T,ROWS>>;
+using pvec = vec<T, ROWS, storage::padded>;
 
 template<sca T, size_t ROWS = 4, size_t COLS = 1>
 using mat = std::conditional_t<COLS == 1, vec<T, ROWS>, vec<T, ROWS>[COLS]>;
@@ -65,6 +79,9 @@ template<size_t N = 1>
 using f32 = std::conditional_t<N == 1, GLfloat, vec<GLfloat, N>>;
 template<size_t N = 1>
 using f64 = std::conditional_t<N == 1, GLdouble, vec<GLdouble, N>>;
+/* half precision float bit patterns, GL_HALF_FLOAT */
+template<size_t N = 1>
+using f16 = std::conditional_t<N == 1, GLhalf, vec<GLhalf, N>>;
 template<size_t N = 1>
 using i8  = std::conditional_t<N == 1, GLbyte, vec<GLbyte, N>>;
 template<size_t N = 1>
@@ -130,6 +147,13 @@ using vec3d_t     = f64<3>;
 using vec5f_t     = f32<5>;
 using vec5d_t     = f64<5>;
 
+using pvec3f_t    = pvec<vecf_t, 3>;
+using pvec3d_t    = pvec<vecd_t, 3>;
+using pvec5f_t    = pvec<vecf_t, 5>;
+using pvec5d_t    = pvec<vecd_t, 5>;
+using pvec6f_t    = pvec<vecf_t, 6>;
+using pvec6d_t    = pvec<vecd_t, 6>;
+
 using vec2f_t     = f32<2>;
 using vec2d_t     = f64<2>;
 using vec2i_t     = i32<2>;
@@ -157,52 +181,1417 @@ template<sca T>
 inline element_aligned<T,3> store3(vector_aligned<T, 4> src, T w = 1)
 {
 	src[3] *= w;
-	if(src[3] != 0 && src[3] != 1)
-		src /= src[3];
+	/* select the divisor instead of branching, GCC 12 if-converts the branch to a lane 0 only AVX-512 masked divide */
+	src /= (src[3] != 0 && src[3] != 1) ? src[3] : (T)1;
 	return (element_aligned<T,3>){ src[0], src[1], src[2] };
 }
 
+/* lanes [OFF, OFF + N) of v as an N lane vector, lanes past the end of v undefined */
+template<sca T, size_t N, size_t OFF = 0, typename V>
+inline __attribute__((__always_inline__)) vector_aligned<T,N> resize(V v)
+{
+	static constexpr size_t K = sizeof(V) / sizeof(T);
+	return [&]<size_t... I>(std::index_sequence<I...>) { return __builtin_shufflevector(v, v, (I + OFF < K ? (int)(I + OFF) : -1)...); }(std::make_index_sequence<N>{});
+}
+
+/* M packed elements at src in the first lanes of an N lane vector, the rest undefined,
+   read as power of two pieces joined in registers so nothing past src[M - 1] is touched */
+template<sca T, size_t M, size_t N>
+inline __attribute__((__always_inline__)) vector_aligned<T,N> load_pieces(const T* src)
+{
+	static constexpr size_t H = std::bit_floor(M);
+	vector_aligned<T,H> lo;
+	__builtin_memcpy(&lo, src, sizeof(lo));
+	if constexpr(H == M)
+		return resize<T,N>(lo);
+	else
+	{
+		vector_aligned<T,H> hi = load_pieces<T, M - H, H>(src + H);
+		return resize<T,N>([&]<size_t... I>(std::index_sequence<I...>) { return __builtin_shufflevector(lo, hi, I...); }(std::make_index_sequence<2 * H>{}));
+	}
+}
+
+/* first M lanes of v to M packed elements at dst as power of two pieces, nothing past dst[M - 1] is touched */
+template<sca T, size_t M, typename V>
+inline __attribute__((__always_inline__)) void store_pieces(T* dst, V v)
+{
+	static constexpr size_t H = std::bit_floor(M);
+	vector_aligned<T,H> lo = resize<T,H>(v);
+	__builtin_memcpy(dst, &lo, sizeof(lo));
+	if constexpr(H != M)
+		store_pieces<T, M - H>(dst + H, resize<T,H,H>(v));
+}
+
+/* lanes below M of a, the rest of b */
+template<size_t M, typename V>
+inline __attribute__((__always_inline__)) V select_lanes(V a, V b)
+{
+	using K = decltype(a < b);
+	static constexpr size_t N = sizeof(V) / sizeof(a[0]);
+	return [&]<size_t... I>(std::index_sequence<I...>) { return (K){ (I < M ? -1 : 0)... } ? a : b; }(std::make_index_sequence<N>{});
+}
+
+/* vector whose lane j is element F(j) of the K vectors v laid end to end, max(1, K - 1) two-source shuffles */
+template<size_t K, typename V, typename F>
+inline __attribute__((__always_inline__)) V gather_lanes(const V (&v)[K], F)
+{
+	static constexpr size_t N = sizeof(V) / sizeof(v[0][0]);
+	return [&]<size_t... J>(std::index_sequence<J...>)
+	{
+		V r = __builtin_shufflevector(v[0], v[K > 1], (F{}(J) < 2 * N ? (int)F{}(J) : -1)...);
+		auto fold = [&]<size_t M>(std::integral_constant<size_t, M>)
+		{
+			r = __builtin_shufflevector(r, v[M], (F{}(J) / N == M ? (int)(N + F{}(J) % N) : (int)J)...);
+		};
+		[&]<size_t... M>(std::index_sequence<M...>) { (fold(std::integral_constant<size_t, M + 2>{}), ...); }(std::make_index_sequence<K - 2>{});
+		return r;
+	}(std::make_index_sequence<N>{});
+}
+
+/* M packed elements at src in the first lanes of V and pad in the rest, nothing past src[M - 1] is read,
+   one AVX-512 masked load where the baseline has them */
+template<typename V, size_t M>
+inline __attribute__((__always_inline__)) V load_masked(const void* src, V pad)
+{
+	using T = std::remove_cvref_t<decltype(pad[0])>;
+	static constexpr size_t N = sizeof(V) / sizeof(T);
+	if constexpr(M >= N)
+	{
+		V v;
+		__builtin_memcpy(&v, src, sizeof(v));
+		return v;
+	}
+	else
+	{
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX512BW__)
+		static constexpr __mmask64 k = (1ull << M) - 1;
+		if constexpr(sizeof(V) == 16)
+		{
+			if constexpr(sizeof(T) == 1) return (V)_mm_mask_loadu_epi8((__m128i)pad, k, src);
+			if constexpr(sizeof(T) == 2) return (V)_mm_mask_loadu_epi16((__m128i)pad, k, src);
+			if constexpr(sizeof(T) == 4) return (V)_mm_mask_loadu_epi32((__m128i)pad, k, src);
+			if constexpr(sizeof(T) == 8) return (V)_mm_mask_loadu_epi64((__m128i)pad, k, src);
+		}
+		if constexpr(sizeof(V) == 32)
+		{
+			if constexpr(sizeof(T) == 1) return (V)_mm256_mask_loadu_epi8((__m256i)pad, k, src);
+			if constexpr(sizeof(T) == 2) return (V)_mm256_mask_loadu_epi16((__m256i)pad, k, src);
+			if constexpr(sizeof(T) == 4) return (V)_mm256_mask_loadu_epi32((__m256i)pad, k, src);
+			if constexpr(sizeof(T) == 8) return (V)_mm256_mask_loadu_epi64((__m256i)pad, k, src);
+		}
+		if constexpr(sizeof(V) == 64)
+		{
+			if constexpr(sizeof(T) == 1) return (V)_mm512_mask_loadu_epi8((__m512i)pad, k, src);
+			if constexpr(sizeof(T) == 2) return (V)_mm512_mask_loadu_epi16((__m512i)pad, k, src);
+			if constexpr(sizeof(T) == 4) return (V)_mm512_mask_loadu_epi32((__m512i)pad, k, src);
+			if constexpr(sizeof(T) == 8) return (V)_mm512_mask_loadu_epi64((__m512i)pad, k, src);
+		}
+#endif
+		return select_lanes<M>(load_pieces<T, M, N>((const T*)src), pad);
+	}
+}
+
+/* first M lanes of v to M packed elements at dst, nothing past dst[M - 1] is written,
+   one AVX-512 masked store where the baseline has them */
+template<size_t M, typename V>
+inline __attribute__((__always_inline__)) void store_masked(void* dst, V v)
+{
+	using T = std::remove_cvref_t<decltype(v[0])>;
+	static constexpr size_t N = sizeof(V) / sizeof(T);
+	if constexpr(M >= N)
+		__builtin_memcpy(dst, &v, sizeof(v));
+	else
+	{
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX512BW__)
+		static constexpr __mmask64 k = (1ull << M) - 1;
+		if constexpr(sizeof(V) == 16)
+		{
+			if constexpr(sizeof(T) == 1) return _mm_mask_storeu_epi8(dst, k, (__m128i)v);
+			if constexpr(sizeof(T) == 2) return _mm_mask_storeu_epi16(dst, k, (__m128i)v);
+			if constexpr(sizeof(T) == 4) return _mm_mask_storeu_epi32(dst, k, (__m128i)v);
+			if constexpr(sizeof(T) == 8) return _mm_mask_storeu_epi64(dst, k, (__m128i)v);
+		}
+		if constexpr(sizeof(V) == 32)
+		{
+			if constexpr(sizeof(T) == 1) return _mm256_mask_storeu_epi8(dst, k, (__m256i)v);
+			if constexpr(sizeof(T) == 2) return _mm256_mask_storeu_epi16(dst, k, (__m256i)v);
+			if constexpr(sizeof(T) == 4) return _mm256_mask_storeu_epi32(dst, k, (__m256i)v);
+			if constexpr(sizeof(T) == 8) return _mm256_mask_storeu_epi64(dst, k, (__m256i)v);
+		}
+		if constexpr(sizeof(V) == 64)
+		{
+			if constexpr(sizeof(T) == 1) return _mm512_mask_storeu_epi8(dst, k, (__m512i)v);
+			if constexpr(sizeof(T) == 2) return _mm512_mask_storeu_epi16(dst, k, (__m512i)v);
+			if constexpr(sizeof(T) == 4) return _mm512_mask_storeu_epi32(dst, k, (__m512i)v);
+			if constexpr(sizeof(T) == 8) return _mm512_mask_storeu_epi64(dst, k, (__m512i)v);
+		}
+#endif
+		store_pieces<T, M>((T*)dst, v);
+	}
+}
+
+/* packed vector to a vector_aligned register of DST lanes rounded up to a power of two, lanes past SRC set to NET */
 template<sca T, size_t SRC, size_t DST, T NET = (T)0> 
 auto load(const element_aligned<T, SRC>& src)
 {
-	static const size_t LEN = power_of_two<DST> ? DST : std::bit_ceil(DST);
-	vector_aligned<T,LEN> dst;
-	std::copy_n(&src[0], LEN <= SRC ? LEN : SRC, &dst[0]);
-	return dst;
+	static constexpr size_t LEN = std::bit_ceil(DST);
+	using V = vector_aligned<T,LEN>;
+	if constexpr(SRC >= LEN)
+		return load_pieces<T, LEN, LEN>(&src[0]);
+	else
+		return select_lanes<SRC>(load_pieces<T, SRC, LEN>(&src[0]), (V){} + NET);
 }
 
+/* vector_aligned register to a packed vector of DST elements, elements past SRC set to NET */
 template<sca T, size_t SRC, size_t DST = SRC, T NET = (T)0>
 auto store(const vector_aligned<T,SRC>& src)
 {
 	element_aligned<T,DST> dst;
-	if(DST > SRC)
-		std::fill(&dst[SRC], &dst[DST - 1], NET);
-	std::copy_n(&src[0], DST <= SRC ? DST : SRC, &dst[0]);
+	if constexpr(DST > SRC)
+		std::fill(dst.begin() + SRC, dst.end(), NET);
+	store_pieces<T, std::min(SRC, DST)>(&dst[0], src);
 	return dst;
 }
 
 template<sca T, size_t N, typename... I>
-inline auto permute(const vec<T, N>& src, const I... args)
+inline constexpr auto permute(const vec<T, N>& src, const I... args)
 {
 	return (vec<T,sizeof...(I)>){ src[args % N]... };
 }
 
-template<size_t N>
-u8<N> ubroundf(f32<N> src)
+/* compile-time index permute, lowers to a single shuffle, non power of two sizes are padded through vector_aligned */
+template<sca T, size_t N, size_t... I> requires (sizeof...(I) > 0)
+inline constexpr vec<T, sizeof...(I)> permute(const vec<T, N>& src)
 {
-	u8<N> dst;
-	for(size_t i = 0; i < N; i++)
-		dst[i] = static_cast<u8<1>>(lroundf(src[i]));
-	return dst;
+	constexpr size_t M = sizeof...(I);
+	/* the padding loads and stores copy through memory */
+	if consteval
+	{
+		return vec<T,M>{ src[I % N]... };
+	}
+	vector_aligned<T, std::bit_ceil(N)> v;
+	if constexpr(power_of_two<N>)
+		v = src;
+	else
+		v = load<T, N, std::bit_ceil(N)>(src);
+	vector_aligned<T, std::bit_ceil(M)> dst = [&]<size_t... P>(std::index_sequence<P...>)
+	{
+		return __builtin_shufflevector(v, v, (I % N)..., ((void)P, -1)...);
+	}(std::make_index_sequence<std::bit_ceil(M) - M>{});
+	if constexpr(power_of_two<M>)
+		return dst;
+	else
+		return store<T, std::bit_ceil(M), M>(dst);
+}
+
+/* bytes of the target's native SIMD register, the width of stdx::native_simd */
+static constexpr size_t simd_native_bytes = sizeof(f32<1>) * stdx::native_simd<f32<1>>::size();
+
+/* lane count of a REG byte SIMD register of T, the native one by default. batch kernels size their packets from the
+   REG simd_dispatch passes them so the clones of wider tiers run wider vectors. stdx::simd backs the native width,
+   the packet sqrt and the to_simd/to_vector interop only, dot, cross, det and the color channel expansion keep their
+   vector_aligned bodies and widen through this count rather than being written on stdx::simd */
+template<sca T, size_t REG = sizeof(T) * stdx::native_simd<T>::size()>
+static constexpr size_t lanes = std::max<size_t>(1, REG / sizeof(T));
+
+/* std::experimental::simd of N lanes of T, a builtin vector ABI whenever the target has registers that wide */
+template<sca T, size_t N>
+using simd_vec = stdx::simd<T, stdx::simd_abi::deduce_t<T, N>>;
+
+/* vector_aligned to simd, zero-copy for builtin ABIs, fixed_size ABIs wider than the target go through the generator */
+template<typename V, typename T = std::remove_cvref_t<decltype(std::declval<V>()[0])>, size_t N = sizeof(V) / sizeof(T)>
+inline __attribute__((__always_inline__)) simd_vec<T,N> to_simd(V v)
+{
+	if constexpr(std::is_constructible_v<simd_vec<T,N>, V>)
+		return simd_vec<T,N>(v);
+	else
+		return simd_vec<T,N>([&](auto i) { return v[decltype(i)::value]; });
+}
+
+/* simd to vector_aligned, the inverse of to_simd */
+template<sca T, typename A, size_t N = stdx::simd_size_v<T, A>>
+inline __attribute__((__always_inline__)) vector_aligned<T,N> to_vector(const stdx::simd<T,A>& s)
+{
+	if constexpr(requires { static_cast<vector_aligned<T,N>>(s); })
+		return static_cast<vector_aligned<T,N>>(s);
+	else
+	{
+		vector_aligned<T,N> v;
+		s.copy_to(&v[0], stdx::element_aligned);
+		return v;
+	}
+}
+
+/* SIMD instruction set tiers of the runtime kernel dispatch */
+enum class simd_tier { sse2, sse41, avx2, avx512 };
+
+/* tier the translation unit is compiled for, kernels never run below it */
+static constexpr simd_tier simd_baseline =
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX512BW__) && defined(__AVX512DQ__)
+	simd_tier::avx512;
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+	simd_tier::avx2;
+#elif defined(__SSE4_1__)
+	simd_tier::sse41;
+#else
+	simd_tier::sse2;
+#endif
+
+/* best tier the cpu supports, capped by IDLIB_SIMD=sse2|sse4.1|avx2|avx512. the variable only lowers the tier, one
+   above what the cpu supports is ignored and kernels never run below simd_baseline whatever it asks for */
+inline simd_tier simd_detect()
+{
+	simd_tier tier = simd_tier::sse2;
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("sse4.1"))
+		tier = simd_tier::sse41;
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c"))
+		tier = simd_tier::avx2;
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq"))
+		tier = simd_tier::avx512;
+#endif
+	static constexpr std::pair<const char*, simd_tier> names[] = {
+		{ "sse2", simd_tier::sse2 }, { "sse4.1", simd_tier::sse41 }, { "avx2", simd_tier::avx2 }, { "avx512", simd_tier::avx512 }
+	};
+	if(const char* env = std::getenv("IDLIB_SIMD"))
+		for(auto [name, cap] : names)
+			if(std::strcmp(env, name) == 0)
+				tier = std::min(tier, cap);
+	return tier;
+}
+
+/* tier the dispatched kernels run at, detected once */
+inline simd_tier simd_active()
+{
+	static const simd_tier tier = std::max(simd_detect(), simd_baseline);
+	return tier;
+}
+
+/* simd_active() set during static initialization and sse2 before, a plain variable for the checks inside kernels
+   where the clones would flatten the guard and detection of the function static into every call */
+inline const simd_tier simd_active_tier = simd_active();
+
+/* whether the instructions of a tier may run, at compile time up to the baseline and through the active tier above
+   it, so helpers reach the forms of a wider tier on vectors the clones of that tier pass them and fall back below */
+inline __attribute__((__always_inline__)) bool simd_has(simd_tier tier)
+{
+	return tier <= simd_baseline || simd_active_tier >= tier;
+}
+
+/* bytes of the SIMD registers kernels built for a tier use, never narrower than the baseline's */
+inline constexpr size_t simd_bytes(simd_tier tier)
+{
+	return std::max<size_t>(simd_native_bytes, tier == simd_tier::avx512 ? 64 : tier == simd_tier::avx2 ? 32 : 16);
+}
+
+/* kernel written as [&]<size_t REG>() { ... }, taking the register bytes of the tier it is built for */
+template<typename F, size_t REG>
+concept simd_sized = requires(F& f) { f.template operator()<REG>(); };
+
+/* f with everything it calls inlined and compiled for one tier, the call is spelled out in each since flatten stops
+   at an always_inline helper and a wider kernel left out of line would take its vectors in the baseline's ABI */
+template<typename F>
+inline __attribute__((__target__("sse4.1"), __flatten__)) auto simd_sse41(F& f)
+{
+	if constexpr(simd_sized<F, simd_bytes(simd_tier::sse41)>)
+		return f.template operator()<simd_bytes(simd_tier::sse41)>();
+	else
+		return f();
+}
+template<typename F>
+inline __attribute__((__target__("avx2,fma,f16c"), __flatten__)) auto simd_avx2(F& f)
+{
+	if constexpr(simd_sized<F, simd_bytes(simd_tier::avx2)>)
+		return f.template operator()<simd_bytes(simd_tier::avx2)>();
+	else
+		return f();
+}
+template<typename F>
+inline __attribute__((__target__("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,f16c"), __flatten__)) auto simd_avx512(F& f)
+{
+	if constexpr(simd_sized<F, simd_bytes(simd_tier::avx512)>)
+		return f.template operator()<simd_bytes(simd_tier::avx512)>();
+	else
+		return f();
+}
+
+/* runs batch kernel f built for the active tier, tiers at or below the baseline run the plain build. kernels written
+   as [&]<size_t REG>() { ... } get the register bytes of the tier and size their vectors with lanes<T,REG>, 16 in the
+   plain x86-64 build and 32 or 64 in its AVX2 and AVX-512 clones, plain [&] { ... } kernels keep the baseline widths
+   and only gain the wider encodings, FMA and the newer shuffles */
+template<typename F>
+inline __attribute__((__always_inline__)) auto simd_run(F& f)
+{
+	const simd_tier tier = simd_active();
+	if constexpr(simd_baseline < simd_tier::avx512)
+		if(tier == simd_tier::avx512)
+			return simd_avx512(f);
+	if constexpr(simd_baseline < simd_tier::avx2)
+		if(tier == simd_tier::avx2)
+			return simd_avx2(f);
+	if constexpr(simd_baseline < simd_tier::sse41)
+		if(tier == simd_tier::sse41)
+			return simd_sse41(f);
+	if constexpr(simd_sized<F, simd_bytes(simd_baseline)>)
+		return f.template operator()<simd_bytes(simd_baseline)>();
+	else
+		return f();
+}
+
+/* simd_run of a batch kernel, recorded under the function calling it when built with IDLIB_PROFILE */
+#if defined(IDLIB_PROFILE)
+template<typename F>
+inline auto simd_dispatch(F&& f, const std::source_location& where = std::source_location::current())
+{
+	return profile_call(where.function_name(), [&] { return simd_run(f); });
+}
+#else
+template<typename F>
+inline auto simd_dispatch(F&& f)
+{
+	return simd_run(f);
+}
+#endif
+
+/* unaligned vector load and store, dispatched kernels move vectors wider than the baseline registers through these
+   since the baseline only aligns them to 16 bytes while code built for a wider tier assumes their full size,
+   the empty asm hides the address so no alignment is inferred from the object it points into */
+template<typename V>
+inline __attribute__((__always_inline__)) V loadu(const void* src)
+{
+	typedef V unaligned __attribute__((__aligned__(1), __may_alias__));
+	asm("" : "+r"(src));
+	return *(const unaligned*)src;
+}
+template<typename V>
+inline __attribute__((__always_inline__)) void storeu(void* dst, V v)
+{
+	typedef V unaligned __attribute__((__aligned__(1), __may_alias__));
+	asm("" : "+r"(dst));
+	*(unaligned*)dst = v;
+}
+
+/* per lane comparison result of V, all bits set in true lanes */
+template<typename V>
+using lane_mask = decltype(V{} < V{});
+
+/* bit l of the result is the sign bit of lane l of the lane mask m, through the widest movemask the baseline has */
+template<typename M>
+inline __attribute__((__always_inline__)) u64<1> lane_bits(M m)
+{
+	using E = std::remove_cvref_t<decltype(m[0])>;
+	static constexpr size_t N = sizeof(M) / sizeof(E);
+	static_assert(N <= 64 && (sizeof(E) == 4 || sizeof(E) == 8));
+	if constexpr(sizeof(M) == 16 && sizeof(E) == 4)
+		return (u64<1>)_mm_movemask_ps((__m128)m);
+	else if constexpr(sizeof(M) == 16)
+		return (u64<1>)_mm_movemask_pd((__m128d)m);
+#if defined(__AVX__)
+	else if constexpr(sizeof(M) == 32 && sizeof(E) == 4)
+		return (u64<1>)_mm256_movemask_ps((__m256)m);
+	else if constexpr(sizeof(M) == 32)
+		return (u64<1>)_mm256_movemask_pd((__m256d)m);
+#endif
+#if defined(__AVX512DQ__)
+	else if constexpr(sizeof(M) == 64 && sizeof(E) == 4)
+		return (u64<1>)_mm512_movepi32_mask((__m512i)m);
+	else if constexpr(sizeof(M) == 64)
+		return (u64<1>)_mm512_movepi64_mask((__m512i)m);
+#endif
+	else
+		return [&]<size_t... I>(std::index_sequence<I...>)
+		{
+			return lane_bits(__builtin_shufflevector(m, m, I...)) | lane_bits(__builtin_shufflevector(m, m, (I + N / 2)...)) << N / 2;
+		}(std::make_index_sequence<N / 2>{});
+}
+
+/* packed N-component vectors to padded registers with the lanes past N set to NET, runs of elements are whole vectors
+   of the tier in and shuffled into padded ones, the rest are read with one full width load overlapping their
+   successors while that stays inside src and masked at the end, returns the count */
+template<sca T, size_t N, T NET = (T)0>
+size_t load(std::span<const vec<T,N>> src, std::span<pvec<T,N>> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		using V = pvec<T,N>;
+		static constexpr size_t P = sizeof(V) / sizeof(T);
+		const size_t len = std::min(src.size(), dst.size());
+		const size_t whole = std::min(len, src.size() * N >= P ? (src.size() * N - P) / N + 1 : 0);
+		const T* s = (const T*)src.data();
+		const V pad = (V){} + NET;
+		size_t i = 0;
+
+		/* W elements are N whole register wide vectors in and P out, each output gathered from the inputs it spans
+		   and a vector of NET for the pad lanes */
+		static constexpr size_t W = std::max(P, lanes<T,REG>);
+		using L = vector_aligned<T,W>;
+		static constexpr auto at = [](size_t f) { return f / P * N + f % P; };
+		for(; i + W <= len; i += W)
+			[&]<size_t... M>(std::index_sequence<M...>)
+			{
+				L e[N];
+				for(size_t k = 0; k < N; k++)
+					e[k] = loadu<L>(&s[i * N + k * W]);
+				(storeu(&dst[i + M * W / P], [&]<size_t... K>(std::index_sequence<K...>)
+				{
+					static constexpr size_t first = at(M * W) / W;
+					const L w[] = { e[first + K]..., (L){} + NET };
+					return gather_lanes(w, [](size_t j) { return (M * W + j) % P < N ? at(M * W + j) - first * W : sizeof...(K) * W; });
+				}(std::make_index_sequence<((M * W + W - 1) / P * N + N - 1) / W - at(M * W) / W + 1>{})), ...);
+			}(std::make_index_sequence<P>{});
+		for(; i < whole; i++)
+			storeu(&dst[i], select_lanes<N>(loadu<V>(&s[i * N]), pad));
+		for(; i < len; i++)
+			storeu(&dst[i], load_masked<V, N>(&s[i * N], pad));
+		return len;
+	});
+}
+
+/* padded registers to packed N-component vectors, runs of elements are shuffled into whole vectors of the tier, the
+   rest are written in order with full width stores whose pad lanes the next element overwrites while that stays
+   inside dst and masked at the end, returns the count */
+template<sca T, size_t N>
+size_t store(std::span<const pvec<T,N>> src, std::span<vec<T,N>> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		using V = pvec<T,N>;
+		static constexpr size_t P = sizeof(V) / sizeof(T);
+		const size_t len = std::min(src.size(), dst.size());
+		const size_t whole = std::min(len, dst.size() * N >= P ? (dst.size() * N - P) / N + 1 : 0);
+		T* d = (T*)dst.data();
+		size_t i = 0;
+
+		/* W elements are P whole register wide vectors in and N out, each output gathered from the inputs it spans */
+		static constexpr size_t W = std::max(P, lanes<T,REG>);
+		using L = vector_aligned<T,W>;
+		static constexpr auto at = [](size_t f) { return f / N * P + f % N; };
+		for(; i + W <= len; i += W)
+			[&]<size_t... M>(std::index_sequence<M...>)
+			{
+				L e[P];
+				for(size_t k = 0; k < P; k++)
+					e[k] = loadu<L>(&src[i + k * W / P]);
+				(storeu(&d[i * N + M * W], [&]<size_t... K>(std::index_sequence<K...>)
+				{
+					static constexpr size_t first = at(M * W) / W;
+					const L w[] = { e[first + K]... };
+					return gather_lanes(w, [](size_t j) { return at(M * W + j) - first * W; });
+				}(std::make_index_sequence<at(M * W + W - 1) / W - at(M * W) / W + 1>{})), ...);
+			}(std::make_index_sequence<N>{});
+		for(; i < whole; i++)
+			storeu(&d[i * N], loadu<V>(&src[i]));
+		for(; i < len; i++)
+			store_masked<N>(&d[i * N], loadu<V>(&src[i]));
+		return len;
+	});
+}
+
+/* rounding of float to integer vector conversions, nearest rounds half away from zero like lroundf */
+enum class rounding { nearest, trunc, floor };
+
+/* normalized integer scaling of vector conversions, unorm maps [0,1] and snorm [-1,1] onto [0,max] and [-max,max] of the integer type */
+enum class scaling { none, unorm, snorm };
+
+/* lane type and count of a scalar, vector_aligned or element_aligned value */
+template<typename V>
+struct lane_traits
+{
+	using type = std::remove_cvref_t<decltype(std::declval<V>()[0])>;
+	static constexpr size_t size = sizeof(V) / sizeof(type);
+};
+template<sca T>
+struct lane_traits<T>
+{
+	using type = T;
+	static constexpr size_t size = 1;
+};
+
+template<typename V>
+concept lane_value = sca<V> || std::is_same_v<V, vector_aligned<typename lane_traits<V>::type, lane_traits<V>::size>>
+                            || std::is_same_v<V, element_aligned<typename lane_traits<V>::type, lane_traits<V>::size>>;
+
+/* largest float T not above the maximum of the integer D, the upper bound of a saturating conversion */
+template<sca D, std::floating_point T>
+static constexpr T saturate_max = []()
+{
+	T h = (T)std::numeric_limits<D>::max();
+	return (long double)h > (long double)std::numeric_limits<D>::max() ? std::nextafter(h, (T)0) : h;
+}();
+
+/* truncating narrow of integer lanes, below AVX-512 GCC scalarizes a narrowing __builtin_convertvector, so 16-byte
+   chunks are reduced to their low bits and combined with the SSE2 packs which then never saturate */
+template<sca D, sca I, size_t N>
+inline __attribute__((__always_inline__)) vector_aligned<D,N> narrow(vector_aligned<I,N> v)
+{
+#if defined(__SSE2__) && !defined(__AVX512BW__)
+	if constexpr(std::is_integral_v<D> && sizeof(D) < sizeof(I) && sizeof(I) <= 4 && sizeof(v) >= 16)
+	{
+		static constexpr size_t C = sizeof(v) / 16;
+		__m128i c[C];
+		__builtin_memcpy(c, &v, sizeof(v));
+		for(size_t k = 0; k < C; k++)
+			c[k] = sizeof(D) == 2 ? _mm_srai_epi32(_mm_slli_epi32(c[k], 16), 16) : _mm_and_si128(c[k], _mm_set1_epi32(sizeof(I) == 4 ? 0xff : 0x00ff00ff));
+		size_t n = C;
+		if constexpr(sizeof(I) == 4)
+		{
+			for(size_t k = 0; k < n; k += 2)
+				c[k / 2] = _mm_packs_epi32(c[k], c[std::min(k + 1, n - 1)]);
+			n = (n + 1) / 2;
+		}
+		if constexpr(sizeof(D) == 1)
+		{
+			for(size_t k = 0; k < n; k += 2)
+				c[k / 2] = _mm_packus_epi16(c[k], c[std::min(k + 1, n - 1)]);
+		}
+		vector_aligned<D,N> d;
+		__builtin_memcpy(&d, c, sizeof(d));
+		return d;
+	}
+#endif
+	return __builtin_convertvector(v, vector_aligned<D,N>);
 }
 
+/* lane wise conversion of N lanes of T to D, the kernel behind vector_cast */
+template<sca D, rounding R, scaling S, bool SATURATE, sca T, size_t N>
+inline __attribute__((__always_inline__)) vector_aligned<D,N> vector_cast_lanes(vector_aligned<T,N> v)
+{
+	using dlim = std::numeric_limits<D>;
+	using tlim = std::numeric_limits<T>;
+	if constexpr(std::is_floating_point_v<T> && std::is_floating_point_v<D>)
+		return __builtin_convertvector(v, vector_aligned<D,N>);
+	else if constexpr(std::is_floating_point_v<T>)
+	{
+		/* clamps are written v > lo ? v : lo so NaN lanes saturate to the lower bound */
+		if constexpr(S != scaling::none)
+		{
+			static constexpr T lo = S == scaling::snorm && std::is_signed_v<D> ? (T)-1 : (T)0;
+			if constexpr(SATURATE)
+			{
+				v = v > lo ? v : lo;
+				v = v < (T)1 ? v : (T)1;
+			}
+			v *= (T)dlim::max();
+		}
+		else if constexpr(SATURATE)
+			v = v > (T)dlim::lowest() ? v : (T)dlim::lowest();
+		/* scaled lanes only exceed D where its maximum rounds up in T */
+		if constexpr(SATURATE && (S == scaling::none || saturate_max<D,T> != (T)dlim::max()))
+			v = v < saturate_max<D,T> ? v : saturate_max<D,T>;
+		/* truncate in a 32-bit or wider integer, then step by the rounding of the exact remainder */
+		using I = std::conditional_t<(sizeof(D) >= 4), D, i32<1>>;
+		vector_aligned<I,N> i = __builtin_convertvector(v, vector_aligned<I,N>);
+		if constexpr(R != rounding::trunc)
+		{
+			vector_aligned<T,N> f = v - __builtin_convertvector(i, vector_aligned<T,N>);
+			if constexpr(R == rounding::nearest)
+				i += __builtin_convertvector(f <= (T)-0.5, vector_aligned<I,N>) - __builtin_convertvector(f >= (T)0.5, vector_aligned<I,N>);
+			else
+				i += __builtin_convertvector(f < 0, vector_aligned<I,N>);
+		}
+		return narrow<D, I, N>(i);
+	}
+	else if constexpr(std::is_floating_point_v<D>)
+	{
+		vector_aligned<D,N> d = __builtin_convertvector(v, vector_aligned<D,N>);
+		if constexpr(S != scaling::none)
+			d /= (D)tlim::max();
+		if constexpr(S == scaling::snorm)
+			d = d > (D)-1 ? d : (D)-1;
+		return d;
+	}
+	else if constexpr(S != scaling::none)
+	{
+		/* normalized rescale between integer depths through float */
+		using F = std::conditional_t<(sizeof(T) < 4 && sizeof(D) < 4), f32<1>, f64<1>>;
+		return vector_cast_lanes<D, R, S, SATURATE, F, N>(vector_cast_lanes<F, R, S, SATURATE, T, N>(v));
+	}
+	else
+	{
+		if constexpr(SATURATE && std::cmp_less(tlim::lowest(), dlim::lowest()))
+			v = v > (T)dlim::lowest() ? v : (T)dlim::lowest();
+		if constexpr(SATURATE && std::cmp_greater(tlim::max(), dlim::max()))
+			v = v < (T)dlim::max() ? v : (T)dlim::max();
+		return narrow<D, T, N>(v);
+	}
+}
+
+/* convert a scalar, vec or element_aligned value lane wise to D, saturating to the range of D unless SATURATE is false,
+   in which case out of range lanes are unspecified, float to float conversions ignore the rounding and scaling */
+template<sca D, rounding R = rounding::nearest, scaling S = scaling::none, bool SATURATE = true, lane_value V>
+inline auto vector_cast(V src)
+{
+	using T = typename lane_traits<V>::type;
+	static constexpr size_t N = lane_traits<V>::size;
+	if constexpr(sca<V>)
+		return vector_cast_lanes<D, R, S, SATURATE, T, 1>((vector_aligned<T,1>){ src })[0];
+	else if constexpr(std::is_same_v<V, vector_aligned<T,N>>)
+		return vector_cast_lanes<D, R, S, SATURATE, T, N>(src);
+	else
+		return store<D, std::bit_ceil(N), N>(vector_cast_lanes<D, R, S, SATURATE, T, std::bit_ceil(N)>(load<T, N, std::bit_ceil(N)>(src)));
+}
+
+/* convert a span of scalars to D, see the single value form, returns the number of converted values */
+template<sca D, rounding R = rounding::nearest, scaling S = scaling::none, bool SATURATE = true, sca T>
+size_t vector_cast(std::span<const T> src, std::span<D> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		/* one register of source lanes of the tier the kernel is built for */
+		static constexpr size_t W = lanes<T,REG>;
+		const size_t len = std::min(src.size(), dst.size());
+		size_t i = 0;
+
+		for(; i + W <= len; i += W)
+			storeu(&dst[i], vector_cast_lanes<D, R, S, SATURATE, T, W>(loadu<vector_aligned<T,W>>(&src[i])));
+
+		if(i < len)
+		{
+			T in[W] = {};
+			D out[W];
+			std::copy_n(&src[i], len - i, in);
+			storeu(out, vector_cast_lanes<D, R, S, SATURATE, T, W>(loadu<vector_aligned<T,W>>(in)));
+			std::copy_n(out, len - i, &dst[i]);
+		}
+		return len;
+	});
+}
+
+/* lane wise round half away from zero to signed size, lroundf semantics saturated to the range of ssz */
+template<size_t N>
+ssz<N> lroundf(f32<N> src) { return vector_cast<ssz<1>>(src); }
+
+/* lane wise lroundf saturated to unsigned bytes */
 template<size_t N>
-ssz<N> lroundf(f32<N> src)
+u8<N> ubroundf(f32<N> src) { return vector_cast<u8<1>>(src); }
+
+/* per 4-lane group shuffle { a[x], a[y], b[z], b[w] } of side by side 4-vectors */
+template<size_t x, size_t y, size_t z, size_t w, typename V>
+inline constexpr __attribute__((__always_inline__)) V shuffle4(V a, V b)
 {
-	ssz<N> dst;
-	for(size_t i = 0; i < N; i++)
-		dst[i] = lroundf(src[i]);
-	return dst;
+	constexpr size_t L = sizeof(V) / sizeof(a[0]);
+	return [&]<size_t... I>(std::index_sequence<I...>) -> V
+	{
+		return __builtin_shufflevector(a, b, ((I % 4 == 0 ? x : I % 4 == 1 ? y : I % 4 == 2 ? z + L : w + L) + I / 4 * 4)...);
+	}(std::make_index_sequence<L>{});
+}
+
+/* per 4-lane group swizzle { v[x], v[y], v[z], v[w] } of side by side 4-vectors */
+template<size_t x, size_t y, size_t z, size_t w, typename V>
+inline constexpr __attribute__((__always_inline__)) V swizzle4(V v) { return shuffle4<x, y, z, w>(v, v); }
+
+/* in-register transpose of four 4-vectors */
+template<typename V>
+inline __attribute__((__always_inline__)) void transpose4(V& r0, V& r1, V& r2, V& r3)
+{
+	V t0 = __builtin_shufflevector(r0, r1, 0, 4, 1, 5);
+	V t1 = __builtin_shufflevector(r2, r3, 0, 4, 1, 5);
+	V t2 = __builtin_shufflevector(r0, r1, 2, 6, 3, 7);
+	V t3 = __builtin_shufflevector(r2, r3, 2, 6, 3, 7);
+	r0 = __builtin_shufflevector(t0, t1, 0, 1, 4, 5);
+	r1 = __builtin_shufflevector(t0, t1, 2, 3, 6, 7);
+	r2 = __builtin_shufflevector(t2, t3, 0, 1, 4, 5);
+	r3 = __builtin_shufflevector(t2, t3, 2, 3, 6, 7);
+}
+
+/* in-register transpose of the N x N matrix held in N vectors of N lanes, stage B swaps the off-diagonal B x B blocks
+   of every 2B x 2B block, log2(N) stages of two-source shuffles */
+template<size_t B = 1, typename V, size_t N>
+inline __attribute__((__always_inline__)) void transpose_lanes(V (&r)[N])
+{
+	static_assert(sizeof(V) / sizeof(r[0][0]) == N && power_of_two<N>);
+	if constexpr(B < N)
+	{
+		[&]<size_t... J>(std::index_sequence<J...>)
+		{
+			for(size_t i = 0; i < N; i++)
+				if((i & B) == 0)
+				{
+					V a = r[i], c = r[i + B];
+					r[i]     = __builtin_shufflevector(a, c, ((J & B) ? J - B + N : J)...);
+					r[i + B] = __builtin_shufflevector(a, c, ((J & B) ? J + N : J + B)...);
+				}
+		}(std::make_index_sequence<N>{});
+		transpose_lanes<2 * B>(r);
+	}
+}
+
+/* G 4-vectors f(0) .. f(G - 1) side by side in one vector */
+template<size_t G, typename F>
+inline __attribute__((__always_inline__)) auto join4(F&& f)
+{
+	if constexpr(G == 1)
+		return f(0);
+	else
+	{
+		auto lo = join4<G / 2>(f), hi = join4<G / 2>([&](size_t g) { return f(g + G / 2); });
+		return [&]<size_t... I>(std::index_sequence<I...>) { return __builtin_shufflevector(lo, hi, I...); }(std::make_index_sequence<4 * G>{});
+	}
+}
+
+/* hands each of the G side by side 4-vectors of v to f(g, v[4g .. 4g + 3]) */
+template<size_t G, typename V, typename F>
+inline __attribute__((__always_inline__)) void split4(V v, F&& f)
+{
+	[&]<size_t... g>(std::index_sequence<g...>)
+	{
+		(f(g, __builtin_shufflevector(v, v, 4 * g, 4 * g + 1, 4 * g + 2, 4 * g + 3)), ...);
+	}(std::make_index_sequence<G>{});
+}
+
+/* 2x2 matrix products of { m00, m01, m10, m11 } packed 4-vectors: a * b, adj(a) * b and a * adj(b) */
+template<typename V>
+inline constexpr __attribute__((__always_inline__)) V mat2_mul(V a, V b)     { return a * swizzle4<0,3,0,3>(b) + swizzle4<1,0,3,2>(a) * swizzle4<2,1,2,1>(b); }
+template<typename V>
+inline constexpr __attribute__((__always_inline__)) V mat2_adj_mul(V a, V b) { return swizzle4<3,3,0,0>(a) * b - swizzle4<1,1,2,2>(a) * swizzle4<2,3,0,1>(b); }
+template<typename V>
+inline constexpr __attribute__((__always_inline__)) V mat2_mul_adj(V a, V b) { return a * swizzle4<3,0,3,0>(b) - swizzle4<1,0,3,2>(a) * swizzle4<2,1,2,1>(b); }
+
+/* 4x4 determinant by 2x2 block cofactors, inverted in place when INVERSE is set,
+   rows r0-r3 may hold several matrices side by side in 4-lane groups, the determinant is broadcast per group */
+template<bool INVERSE, typename V>
+inline constexpr __attribute__((__always_inline__)) V cofactor4(V& r0, V& r1, V& r2, V& r3)
+{
+	V A   = shuffle4<0,1,0,1>(r0, r1), B = shuffle4<2,3,2,3>(r0, r1);
+	V C   = shuffle4<0,1,0,1>(r2, r3), D = shuffle4<2,3,2,3>(r2, r3);
+	V sub = shuffle4<0,2,0,2>(r0, r2) * shuffle4<1,3,1,3>(r1, r3) - shuffle4<1,3,1,3>(r0, r2) * shuffle4<0,2,0,2>(r1, r3);
+	V dA  = swizzle4<0,0,0,0>(sub), dB = swizzle4<1,1,1,1>(sub), dC = swizzle4<2,2,2,2>(sub), dD = swizzle4<3,3,3,3>(sub);
+	V DC  = mat2_adj_mul(D, C), AB = mat2_adj_mul(A, B);
+	V tr  = AB * swizzle4<0,2,1,3>(DC);
+	tr   += swizzle4<1,0,3,2>(tr);
+	tr   += swizzle4<2,3,0,1>(tr);
+	V det = dA * dD + dB * dC - tr;
+	if constexpr(INVERSE)
+	{
+		constexpr size_t L = sizeof(V) / sizeof(det[0]);
+		V sign = [&]<size_t... I>(std::index_sequence<I...>) -> V { return (V){ ((I % 4 == 1 || I % 4 == 2) ? -1 : 1)... }; }(std::make_index_sequence<L>{});
+		V rdet = sign / det;
+		V X = (dD * A - mat2_mul(B, DC)) * rdet;
+		V W = (dA * D - mat2_mul(C, AB)) * rdet;
+		V Y = (dB * C - mat2_mul_adj(D, AB)) * rdet;
+		V Z = (dC * B - mat2_mul_adj(A, DC)) * rdet;
+		r0 = shuffle4<3,1,3,1>(X, Y);
+		r1 = shuffle4<2,0,2,0>(X, Y);
+		r2 = shuffle4<3,1,3,1>(Z, W);
+		r3 = shuffle4<2,0,2,0>(Z, W);
+	}
+	return det;
+}
+
+/* 4x4 matrix determinant */
+template<sca T>
+inline constexpr T det(const mat<T,4,4>& src)
+{
+	vec<T,4> r0 = src[0], r1 = src[1], r2 = src[2], r3 = src[3];
+	return cofactor4<false>(r0, r1, r2, r3)[0];
+}
+
+/* general 4x4 matrix inverse, returns the determinant and leaves dst untouched when it is zero */
+template<sca T>
+inline constexpr T inverse(const mat<T,4,4>& src, mat<T,4,4>& dst)
+{
+	vec<T,4> r0 = src[0], r1 = src[1], r2 = src[2], r3 = src[3];
+	T d = cofactor4<true>(r0, r1, r2, r3)[0];
+	if(d == 0)
+		return d;
+	dst[0] = r0; dst[1] = r1; dst[2] = r2; dst[3] = r3;
+	return d;
+}
+
+/* affine inverse from the transposed 3x3 inverse rows r0-r2 and the translation column t */
+template<sca T>
+inline void inverse_affine_store(vec<T,4> r0, vec<T,4> r1, vec<T,4> r2, vec<T,4> t, mat<T,4,4>& dst)
+{
+	vec<T,4> r3 = {};
+	transpose4(r0, r1, r2, r3);
+	r0[3] = r1[3] = r2[3] = 0;
+	r3 = -(r0 * t[0] + r1 * t[1] + r2 * t[2]);
+	r3[3] = 1;
+	dst[0] = r0; dst[1] = r1; dst[2] = r2; dst[3] = r3;
+}
+
+/* affine 4x4 matrix inverse, last row (0,0,0,1), returns the 3x3 determinant and leaves dst untouched when it is zero */
+template<sca T>
+inline T inverse_affine(const mat<T,4,4>& src, mat<T,4,4>& dst)
+{
+	vec<T,4> c0 = src[0], c1 = src[1], c2 = src[2];
+	vec<T,4> r0 = swizzle4<1,2,0,3>(c1) * swizzle4<2,0,1,3>(c2) - swizzle4<2,0,1,3>(c1) * swizzle4<1,2,0,3>(c2);
+	vec<T,4> r1 = swizzle4<1,2,0,3>(c2) * swizzle4<2,0,1,3>(c0) - swizzle4<2,0,1,3>(c2) * swizzle4<1,2,0,3>(c0);
+	vec<T,4> r2 = swizzle4<1,2,0,3>(c0) * swizzle4<2,0,1,3>(c1) - swizzle4<2,0,1,3>(c0) * swizzle4<1,2,0,3>(c1);
+	vec<T,4> p  = c0 * r0;
+	T d = p[0] + p[1] + p[2];
+	if(d == 0)
+		return d;
+	T rdet = 1 / d;
+	inverse_affine_store<T>(r0 * rdet, r1 * rdet, r2 * rdet, src[3], dst);
+	return d;
+}
+
+/* rigid body (orthonormal rotation and translation) 4x4 matrix inverse */
+template<sca T>
+inline void inverse_rigid(const mat<T,4,4>& src, mat<T,4,4>& dst)
+{
+	inverse_affine_store<T>(src[0], src[1], src[2], src[3], dst);
+}
+
+/* batched general 4x4 matrix inverse, a register of the dispatched tier worth of matrices per step,
+   singular matrices leave their dst untouched like the single matrix inverse, returns the count */
+template<sca T>
+size_t inverse(std::span<const mat<T,4,4>> src, std::span<mat<T,4,4>> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = std::min(src.size(), dst.size());
+		size_t i = 0;
+
+		for(; i + G <= len; i += G)
+		{
+			V r0 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][0]); });
+			V r1 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][1]); });
+			V r2 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][2]); });
+			V r3 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][3]); });
+			/* singular matrices are rare, the whole step is stored unless one of its determinants is zero */
+			const V d = cofactor4<true>(r0, r1, r2, r3);
+			const bool all = lane_bits(d == 0) == 0;
+			split4<G>(r0, [&](size_t g, vec<T,4> v) { if(all || d[4 * g] != 0) storeu(&dst[i + g][0], v); });
+			split4<G>(r1, [&](size_t g, vec<T,4> v) { if(all || d[4 * g] != 0) storeu(&dst[i + g][1], v); });
+			split4<G>(r2, [&](size_t g, vec<T,4> v) { if(all || d[4 * g] != 0) storeu(&dst[i + g][2], v); });
+			split4<G>(r3, [&](size_t g, vec<T,4> v) { if(all || d[4 * g] != 0) storeu(&dst[i + g][3], v); });
+		}
+		for(; i < len; i++)
+		{
+			vec<T,4> r0 = loadu<vec<T,4>>(&src[i][0]), r1 = loadu<vec<T,4>>(&src[i][1]);
+			vec<T,4> r2 = loadu<vec<T,4>>(&src[i][2]), r3 = loadu<vec<T,4>>(&src[i][3]);
+			if(cofactor4<true>(r0, r1, r2, r3)[0] == 0)
+				continue;
+			storeu(&dst[i][0], r0); storeu(&dst[i][1], r1); storeu(&dst[i][2], r2); storeu(&dst[i][3], r3);
+		}
+		return len;
+	});
+}
+
+/* batched 4x4 matrix determinants, returns the number of computed determinants */
+template<sca T>
+size_t det(std::span<const mat<T,4,4>> src, std::span<T> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = std::min(src.size(), dst.size());
+		size_t i = 0;
+
+		for(; i + G <= len; i += G)
+		{
+			V r0 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][0]); });
+			V r1 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][1]); });
+			V r2 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][2]); });
+			V r3 = join4<G>([&](size_t g) { return loadu<vec<T,4>>(&src[i + g][3]); });
+			V d  = cofactor4<false>(r0, r1, r2, r3);
+			for(size_t g = 0; g < G; g++)
+				dst[i + g] = d[4 * g];
+		}
+		for(; i < len; i++)
+		{
+			vec<T,4> r0 = loadu<vec<T,4>>(&src[i][0]), r1 = loadu<vec<T,4>>(&src[i][1]);
+			vec<T,4> r2 = loadu<vec<T,4>>(&src[i][2]), r3 = loadu<vec<T,4>>(&src[i][3]);
+			dst[i] = cofactor4<false>(r0, r1, r2, r3)[0];
+		}
+		return len;
+	});
+}
+
+/* non-temporal store of a whole vector bypassing the cache, plain store when the width has no streaming form */
+template<typename V>
+inline __attribute__((__always_inline__)) void stream(V* dst, V src)
+{
+#if defined(__AVX512F__)
+	if constexpr(sizeof(V) == 64)
+		return _mm512_stream_si512((__m512i*)dst, (__m512i)src);
+#endif
+#if defined(__AVX__)
+	if constexpr(sizeof(V) == 32)
+		return _mm256_stream_si256((__m256i*)dst, (__m256i)src);
+#endif
+#if defined(__SSE2__)
+	if constexpr(sizeof(V) == 16)
+		return _mm_stream_si128((__m128i*)dst, (__m128i)src);
+	/* vectors wider than the baseline registers, those of the clones of wider tiers, in 16-byte pieces */
+	if constexpr(sizeof(V) % 16 == 0)
+	{
+		__m128i h[sizeof(V) / 16];
+		__builtin_memcpy(h, &src, sizeof(V));
+		for(size_t k = 0; k < sizeof(V) / 16; k++)
+			_mm_stream_si128((__m128i*)dst + k, h[k]);
+		return;
+	}
+#endif
+	storeu(dst, src);
+}
+
+/* matrix vector product */
+template<sca T>
+inline vec<T,4> mul(const mat<T,4,4>& m, vec<T,4> v)
+{
+	return m[0] * v[0] + m[1] * v[1] + m[2] * v[2] + m[3] * v[3];
+}
+
+/* 4x4 matrix product a * b, dst may alias either operand */
+template<sca T>
+inline void mul(const mat<T,4,4>& a, const mat<T,4,4>& b, mat<T,4,4>& dst)
+{
+	vec<T,4> c0 = mul<T>(a, b[0]), c1 = mul<T>(a, b[1]), c2 = mul<T>(a, b[2]), c3 = mul<T>(a, b[3]);
+	dst[0] = c0; dst[1] = c1; dst[2] = c2; dst[3] = c3;
+}
+
+/* 3x4 affine matrix product a * b of matrices with last row (0,0,0,1), dst may alias either operand */
+template<sca T>
+inline void mul_affine(const mat<T,4,4>& a, const mat<T,4,4>& b, mat<T,4,4>& dst)
+{
+	vec<T,4> c0 = a[0] * b[0][0] + a[1] * b[0][1] + a[2] * b[0][2];
+	vec<T,4> c1 = a[0] * b[1][0] + a[1] * b[1][1] + a[2] * b[1][2];
+	vec<T,4> c2 = a[0] * b[2][0] + a[1] * b[2][1] + a[2] * b[2][2];
+	vec<T,4> c3 = a[0] * b[3][0] + a[1] * b[3][1] + a[2] * b[3][2] + a[3];
+	c0[3] = c1[3] = c2[3] = 0;
+	c3[3] = 1;
+	dst[0] = c0; dst[1] = c1; dst[2] = c2; dst[3] = c3;
+}
+
+/* transpose of a ROWS x COLS matrix into a COLS x ROWS one, dst may alias src when square,
+   square matrices that fit one native register are a single permute, others have their columns padded to
+   N = bit_ceil(max(ROWS, COLS)) lanes and transposed in registers, matrices more than two native registers wide
+   are copied element by element */
+template<sca T, size_t ROWS, size_t COLS>
+requires (ROWS > 1 && COLS > 1)
+inline void transpose(const mat<T,ROWS,COLS>& src, mat<T,COLS,ROWS>& dst)
+{
+	static constexpr size_t N = std::bit_ceil(std::max(ROWS, COLS));
+	if constexpr(ROWS == N && COLS == N && N * N <= lanes<T>)
+	{
+		using V = vector_aligned<T,N * N>;
+		V m = loadu<V>(&src[0]);
+		[&]<size_t... J>(std::index_sequence<J...>) { storeu(&dst[0], __builtin_shufflevector(m, m, (J % N * N + J / N)...)); }(std::make_index_sequence<N * N>{});
+	}
+	else if constexpr(N * sizeof(T) <= 64 && N <= 2 * lanes<T>)
+	{
+		vector_aligned<T,N> r[N] = {};
+		for(size_t c = 0; c < COLS; c++)
+			__builtin_memcpy(&r[c], &src[c], ROWS * sizeof(T));
+		transpose_lanes(r);
+		for(size_t c = 0; c < ROWS; c++)
+			__builtin_memcpy(&dst[c], &r[c], COLS * sizeof(T));
+	}
+	else
+	{
+		mat<T,COLS,ROWS> tmp;
+		for(size_t c = 0; c < COLS; c++)
+			for(size_t r = 0; r < ROWS; r++)
+				tmp[r][c] = src[c][r];
+		std::copy_n(&tmp[0], ROWS, &dst[0]);
+	}
+}
+
+/* packed 3-vectors at src split into x, y and z vectors of one element per lane, 4-vectors with two shuffles per
+   component and wider ones gathered from three whole loads */
+template<sca T, typename V>
+inline __attribute__((__always_inline__)) void deinterleave3(const T* src, V& x, V& y, V& z)
+{
+	static constexpr size_t N = sizeof(V) / sizeof(T);
+	if constexpr(N == 4)
+	{
+		V a, b, c;
+		__builtin_memcpy(&a, src, sizeof(a));
+		__builtin_memcpy(&b, src + 4, sizeof(b));
+		__builtin_memcpy(&c, src + 8, sizeof(c));
+		x = __builtin_shufflevector(__builtin_shufflevector(a, b, 0, 3, 6, -1), c, 0, 1, 2, 5);
+		y = __builtin_shufflevector(__builtin_shufflevector(a, b, 1, 4, 7, -1), c, 0, 1, 2, 6);
+		z = __builtin_shufflevector(__builtin_shufflevector(a, b, 2, 5, -1, -1), c, 0, 1, 4, 7);
+	}
+	else
+	{
+		const V v[3] = { loadu<V>(src), loadu<V>(src + N), loadu<V>(src + 2 * N) };
+		x = gather_lanes(v, [](size_t j) { return 3 * j; });
+		y = gather_lanes(v, [](size_t j) { return 3 * j + 1; });
+		z = gather_lanes(v, [](size_t j) { return 3 * j + 2; });
+	}
+}
+
+/* x, y and z vectors packed into 3-vectors at dst, STREAM requires a vector aligned dst */
+template<sca T, bool STREAM = false, typename V>
+inline __attribute__((__always_inline__)) void interleave3(T* dst, V x, V y, V z)
+{
+	static constexpr size_t N = sizeof(V) / sizeof(T);
+	V a, b, c;
+	if constexpr(N == 4)
+	{
+		a = __builtin_shufflevector(__builtin_shufflevector(x, y, 0, 4, 1, 5), z, 0, 1, 4, 2);
+		b = __builtin_shufflevector(__builtin_shufflevector(y, z, 1, 5, 2, 6), x, 0, 1, 6, 2);
+		c = __builtin_shufflevector(z, __builtin_shufflevector(x, y, 3, 7, 3, 7), 2, 4, 5, 3);
+	}
+	else
+	{
+		const V v[3] = { x, y, z };
+		a = gather_lanes(v, [](size_t j) { return j % 3 * N + j / 3; });
+		b = gather_lanes(v, [](size_t j) { return (N + j) % 3 * N + (N + j) / 3; });
+		c = gather_lanes(v, [](size_t j) { return (2 * N + j) % 3 * N + (2 * N + j) / 3; });
+	}
+	if constexpr(STREAM)
+	{
+		stream((V*)dst, a);
+		stream((V*)(dst + N), b);
+		stream((V*)(dst + 2 * N), c);
+	}
+	else if constexpr(N == 4)
+	{
+		__builtin_memcpy(dst, &a, sizeof(a));
+		__builtin_memcpy(dst + 4, &b, sizeof(b));
+		__builtin_memcpy(dst + 8, &c, sizeof(c));
+	}
+	else
+	{
+		storeu(dst, a);
+		storeu(dst + N, b);
+		storeu(dst + 2 * N, c);
+	}
+}
+
+/* transform of 3-component points (POINT, w = 1) or directions (w = 0) by m,
+   PROJECT divides by the resulting w like store3, STREAM writes the output with non-temporal stores,
+   a register of the tier of packed vec3 is split into components per step, returns the number of transformed elements */
+template<sca T, bool POINT, bool PROJECT = false, bool STREAM = false>
+size_t transform3(const mat<T,4,4>& m, std::span<const vec<T,3>> src, std::span<vec<T,3>> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t W = std::max<size_t>(4, lanes<T,REG>);
+		using V = vector_aligned<T,4>;
+		using L = vector_aligned<T,W>;
+		const size_t len = std::min(src.size(), dst.size());
+		const V m0 = loadu<V>(&m[0]), m1 = loadu<V>(&m[1]), m2 = loadu<V>(&m[2]), m3 = POINT ? loadu<V>(&m[3]) : (V){};
+		size_t i = 0;
+
+		auto one = [&](size_t k)
+		{
+			V v = m0 * src[k][0] + m1 * src[k][1] + m2 * src[k][2] + m3;
+			if constexpr(PROJECT)
+				v /= (v[3] != 0 && v[3] != 1) ? v[3] : (T)1;
+			dst[k] = (vec<T,3>){ v[0], v[1], v[2] };
+		};
+
+		/* W vec3 are 3 whole L, element k of a T aligned dst starts on an L boundary for one k below W */
+		if constexpr(STREAM)
+			for(; i < std::min(len, W) && (uintptr_t)&dst[i] % sizeof(L) != 0; i++)
+				one(i);
+		const bool aligned = (uintptr_t)&dst[i] % sizeof(L) == 0;
+
+		for(; len - i >= W; i += W)
+		{
+			L x, y, z;
+			deinterleave3<T>(&src[i][0], x, y, z);
+			L X = m0[0] * x + m1[0] * y + m2[0] * z + m3[0];
+			L Y = m0[1] * x + m1[1] * y + m2[1] * z + m3[1];
+			L Z = m0[2] * x + m1[2] * y + m2[2] * z + m3[2];
+			if constexpr(PROJECT)
+			{
+				L w = m0[3] * x + m1[3] * y + m2[3] * z + m3[3];
+				w = (w != 0 && w != 1) ? w : 1;
+				X /= w; Y /= w; Z /= w;
+			}
+			if(STREAM && aligned)
+				interleave3<T, true>(&dst[i][0], X, Y, Z);
+			else
+				interleave3<T>(&dst[i][0], X, Y, Z);
+		}
+		for(; i < len; i++)
+			one(i);
+		if constexpr(STREAM)
+			_mm_sfence();
+		return len;
+	});
+}
+
+/* transform of 3-component points, translated and optionally projected */
+template<sca T, bool PROJECT = false, bool STREAM = false>
+inline size_t transform_points(const mat<T,4,4>& m, std::span<const vec<T,3>> src, std::span<vec<T,3>> dst)
+{
+	return transform3<T, true, PROJECT, STREAM>(m, src, dst);
+}
+
+/* transform of 3-component directions, ignoring translation */
+template<sca T, bool STREAM = false>
+inline size_t transform_vectors(const mat<T,4,4>& m, std::span<const vec<T,3>> src, std::span<vec<T,3>> dst)
+{
+	return transform3<T, false, false, STREAM>(m, src, dst);
+}
+
+/* transform of homogeneous 4-component vectors, G = lanes<T,REG> / 4 vectors side by side per step each multiplied by
+   the per group splats of its own components, STREAM writes whole steps from a register aligned element on,
+   returns the number of transformed elements */
+template<sca T, bool STREAM = false>
+size_t transform(const mat<T,4,4>& m, std::span<const vec<T,4>> src, std::span<vec<T,4>> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = std::min(src.size(), dst.size());
+		const vec<T,4> m0 = loadu<vec<T,4>>(&m[0]), m1 = loadu<vec<T,4>>(&m[1]), m2 = loadu<vec<T,4>>(&m[2]), m3 = loadu<vec<T,4>>(&m[3]);
+		const V M0 = join4<G>([&](size_t) { return m0; }), M1 = join4<G>([&](size_t) { return m1; });
+		const V M2 = join4<G>([&](size_t) { return m2; }), M3 = join4<G>([&](size_t) { return m3; });
+		size_t i = 0;
+
+		auto one = [&](size_t k)
+		{
+			vec<T,4> v = loadu<vec<T,4>>(&src[k]);
+			v = m0 * v[0] + m1 * v[1] + m2 * v[2] + m3 * v[3];
+			if constexpr(STREAM)
+				stream(&dst[k], v);
+			else
+				storeu(&dst[k], v);
+		};
+
+		if constexpr(STREAM)
+			for(; i < len && (uintptr_t)&dst[i] % sizeof(V) != 0; i++)
+				one(i);
+		for(; i + G <= len; i += G)
+		{
+			V v = loadu<V>(&src[i]);
+			v = M0 * swizzle4<0,0,0,0>(v) + M1 * swizzle4<1,1,1,1>(v) + M2 * swizzle4<2,2,2,2>(v) + M3 * swizzle4<3,3,3,3>(v);
+			if constexpr(STREAM)
+				stream((V*)&dst[i], v);
+			else
+				storeu(&dst[i], v);
+		}
+		for(; i < len; i++)
+			one(i);
+		if constexpr(STREAM)
+			_mm_sfence();
+		return len;
+	});
+}
+
+/* lanes<T,REG> square tiles of the R x C top left corner of a rows x cols row-major src transposed into the cols x rows
+   row-major dst, tiles run down strips a cache line tall and are stored line by line so every dst row receives
+   whole lines, STREAM needs vector aligned dst rows */
+template<sca T, bool STREAM, size_t REG>
+inline __attribute__((__always_inline__)) void transpose_tiles(const T* src, T* dst, size_t rows, size_t cols, size_t R, size_t C)
+{
+	static constexpr size_t B = lanes<T,REG>;
+	static constexpr size_t H = std::max<size_t>(B, 64 / sizeof(T));
+	using V = vector_aligned<T,B>;
+
+	for(size_t r0 = 0; r0 < R; r0 += H)
+		for(size_t c = 0; c < C; c += B)
+		{
+			const size_t q = std::min(H, R - r0) / B;
+			V t[H / B][B];
+			for(size_t j = 0; j < q; j++)
+			{
+				for(size_t k = 0; k < B; k++)
+					t[j][k] = loadu<V>(&src[(r0 + j * B + k) * cols + c]);
+				transpose_lanes(t[j]);
+			}
+			for(size_t k = 0; k < B; k++)
+				for(size_t j = 0; j < q; j++)
+					if constexpr(STREAM)
+						stream((V*)&dst[(c + k) * rows + r0 + j * B], t[j][k]);
+					else
+						storeu(&dst[(c + k) * rows + r0 + j * B], t[j][k]);
+		}
+}
+
+/* K-column rows into K planes (PLANAR) or K planes into K-column rows, n elements per plane,
+   every step moves K whole vectors of lanes<T,REG> and returns the number of elements per plane done */
+template<sca T, size_t K, bool PLANAR, size_t REG>
+inline __attribute__((__always_inline__)) size_t transpose_narrow(const T* src, T* dst, size_t n)
+{
+	static constexpr size_t B = lanes<T,REG>;
+	using V = vector_aligned<T,B>;
+	size_t i = 0;
+
+	for(; i + B <= n; i += B)
+		[&]<size_t... M>(std::index_sequence<M...>)
+		{
+			if constexpr(PLANAR)
+			{
+				const V v[K] = { loadu<V>(&src[i * K + M * B])... };
+				(storeu(&dst[M * n + i], gather_lanes(v, [](size_t j) { return j * K + M; })), ...);
+			}
+			else
+			{
+				const V v[K] = { loadu<V>(&src[M * n + i])... };
+				(storeu(&dst[i * K + M * B], gather_lanes(v, [](size_t j) { return (M * B + j) % K * B + (M * B + j) / K; })), ...);
+			}
+		}(std::make_index_sequence<K>{});
+	return i;
+}
+
+/* rows x cols row-major src transposed into cols x rows row-major dst, register wide square tiles are transposed in registers,
+   layouts of 2 to 4 columns or rows such as interleaved and planar vertex streams are shuffled a few vectors at a time,
+   STREAM writes square tiles with non-temporal stores when dst and its rows are vector aligned,
+   returns the number of transposed elements, 0 when either span is shorter than rows * cols */
+template<sca T, bool STREAM = false>
+size_t transpose(std::span<const T> src, std::span<T> dst, size_t rows, size_t cols)
+{
+	const size_t len = rows * cols;
+	if(src.size() < len || dst.size() < len)
+		return 0;
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t B = lanes<T,REG>;
+		const T* s = src.data();
+		T* d = dst.data();
+		size_t R = rows - rows % B, C = cols - cols % B;
+
+		auto narrow = [&](size_t k, size_t n, auto planar)
+		{
+			switch(k)
+			{
+				case 2: return B > 2 ? transpose_narrow<T, 2, planar, REG>(s, d, n) : 0;
+				case 3: return B > 3 ? transpose_narrow<T, 3, planar, REG>(s, d, n) : 0;
+				case 4: return B > 4 ? transpose_narrow<T, 4, planar, REG>(s, d, n) : 0;
+				default: return (size_t)0;
+			}
+		};
+
+		if(R > 0 && C > 0)
+		{
+			if(STREAM && rows % B == 0 && (uintptr_t)d % sizeof(vector_aligned<T,B>) == 0)
+				transpose_tiles<T, STREAM, REG>(s, d, rows, cols, R, C);
+			else
+				transpose_tiles<T, false, REG>(s, d, rows, cols, R, C);
+		}
+		else if(cols < B)
+			R = narrow(cols, rows, std::true_type{}), C = cols;
+		else
+			C = narrow(rows, cols, std::false_type{}), R = rows;
+
+		for(size_t r = 0; r < R; r++)
+			for(size_t c = C; c < cols; c++)
+				d[c * rows + r] = s[r * cols + c];
+		for(size_t r = R; r < rows; r++)
+			for(size_t c = 0; c < cols; c++)
+				d[c * rows + r] = s[r * cols + c];
+		if constexpr(STREAM)
+			_mm_sfence();
+		return len;
+	});
+}
+
+/* 4 * G side by side 4-vectors r0-r3 transposed per 4-lane group, component c of row k lands in lane 4g + k of r[c] */
+template<typename V>
+inline __attribute__((__always_inline__)) void transpose4_groups(V& r0, V& r1, V& r2, V& r3)
+{
+	V t0 = shuffle4<0,1,0,1>(r0, r1), t1 = shuffle4<2,3,2,3>(r0, r1);
+	V t2 = shuffle4<0,1,0,1>(r2, r3), t3 = shuffle4<2,3,2,3>(r2, r3);
+	r0 = shuffle4<0,2,0,2>(t0, t2);
+	r1 = shuffle4<1,3,1,3>(t0, t2);
+	r2 = shuffle4<0,2,0,2>(t1, t3);
+	r3 = shuffle4<1,3,1,3>(t1, t3);
+}
+
+/* batched 4-component dot products, the products of 4 * G vector pairs are transposed in registers per step
+   so whole vectors of results come out of vertical adds instead of one horizontal reduction per pair,
+   returns the number of dot products */
+template<sca T>
+size_t dot(std::span<const vec<T,4>> a, std::span<const vec<T,4>> b, std::span<T> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = std::min({ a.size(), b.size(), dst.size() });
+		size_t i = 0;
+
+		auto row = [&](size_t k) { return join4<G>([&](size_t g) { return loadu<vec<T,4>>(&a[i + 4 * g + k]) * loadu<vec<T,4>>(&b[i + 4 * g + k]); }); };
+		for(; i + 4 * G <= len; i += 4 * G)
+		{
+			V p0 = row(0), p1 = row(1), p2 = row(2), p3 = row(3);
+			transpose4_groups(p0, p1, p2, p3);
+			storeu(&dst[i], (p0 + p1) + (p2 + p3));
+		}
+		for(; i < len; i++)
+		{
+			vec<T,4> p = loadu<vec<T,4>>(&a[i]) * loadu<vec<T,4>>(&b[i]);
+			dst[i] = (p[0] + p[1]) + (p[2] + p[3]);
+		}
+		return len;
+	});
+}
+
+/* batched 3-component dot products, four packed vec3 per 4-lane group are split into components, returns the number of dot products */
+template<sca T>
+size_t dot(std::span<const vec<T,3>> a, std::span<const vec<T,3>> b, std::span<T> dst)
+{
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = std::min({ a.size(), b.size(), dst.size() });
+		size_t i = 0;
+
+		for(; i + 4 * G <= len; i += 4 * G)
+		{
+			vector_aligned<T,4> ax[G], ay[G], az[G], bx[G], by[G], bz[G];
+			for(size_t g = 0; g < G; g++)
+			{
+				deinterleave3<T>(&a[i + 4 * g][0], ax[g], ay[g], az[g]);
+				deinterleave3<T>(&b[i + 4 * g][0], bx[g], by[g], bz[g]);
+			}
+			V d = join4<G>([&](size_t g) { return ax[g] * bx[g] + ay[g] * by[g] + az[g] * bz[g]; });
+			storeu(&dst[i], d);
+		}
+		for(; i < len; i++)
+			dst[i] = a[i][0] * b[i][0] + a[i][1] * b[i][1] + a[i][2] * b[i][2];
+		return len;
+	});
+}
+
+/* signed distances of every point to every plane, dst[j * points.size() + i] is point i against plane j,
+   each block of points is split into components once and tested against all planes,
+   returns the number of distances, whole planes only */
+template<sca T>
+size_t distance(std::span<const vec<T,3>> points, std::span<const vec<T,4>> planes, std::span<T> dst)
+{
+	if(points.empty())
+		return 0;
+	return simd_dispatch([&]<size_t REG>()
+	{
+		static constexpr size_t G = std::max<size_t>(1, lanes<T,REG> / 4);
+		using V = vector_aligned<T, 4 * G>;
+		const size_t len = points.size();
+		const size_t rows = std::min(planes.size(), dst.size() / len);
+		size_t i = 0;
+
+		for(; i + 4 * G <= len; i += 4 * G)
+		{
+			vector_aligned<T,4> px[G], py[G], pz[G];
+			for(size_t g = 0; g < G; g++)
+				deinterleave3<T>(&points[i + 4 * g][0], px[g], py[g], pz[g]);
+			V x = join4<G>([&](size_t g) { return px[g]; });
+			V y = join4<G>([&](size_t g) { return py[g]; });
+			V z = join4<G>([&](size_t g) { return pz[g]; });
+			for(size_t j = 0; j < rows; j++)
+			{
+				const vec<T,4> n = loadu<vec<T,4>>(&planes[j]);
+				storeu(&dst[j * len + i], x * n[0] + y * n[1] + z * n[2] + n[3]);
+			}
+		}
+		for(; i < len; i++)
+			for(size_t j = 0; j < rows; j++)
+				dst[j * len + i] = points[i][0] * planes[j][0] + points[i][1] * planes[j][1] + points[i][2] * planes[j][2] + planes[j][3];
+		return rows * len;
+	});
+}
+
+/* signed distances n . p + w of 3-component points to the plane { n, w }, returns the number of distances */
+template<sca T>
+size_t distance(std::span<const vec<T,3>> points, const vec<T,4>& plane, std::span<T> dst)
+{
+	return distance<T>(points, std::span<const vec<T,4>>(&plane, 1), dst);
 }
 
 namespace col
@@ -221,6 +1610,9 @@ namespace col
 	static constexpr fmt bgra8888     = {{2,1,0,3}, {8,8,8,8}};
 	static constexpr fmt argb8888     = {{3,0,1,2}, {8,8,8,8}};
 
+	/* GL_UNSIGNED_INT_2_10_10_10_REV */
+	static constexpr fmt rgba1010102  = {{0,1,2,3}, {10,10,10,2}};
+
 	static constexpr fmt rgba16161616 = {{0,1,2,3}, {16,16,16,16}};
 	static constexpr fmt bgra16161616 = {{2,1,0,3}, {16,16,16,16}};
 	static constexpr fmt argb16161616 = {{3,0,1,2}, {16,16,16,16}};
@@ -253,6 +1645,23 @@ namespace col
 		none = (uint8_t)-1,
 	};
 
+	/* v of a FROM-bit normalized channel rescaled to TO bits, rounded to nearest like the float conversions */
+	constexpr type::u64<1> unorm_rescale(type::u64<1> v, size_t from, size_t to)
+	{
+		const type::u64<1> d = ((type::u64<1>)1 << from) - 1, m = ((type::u64<1>)1 << to) - 1;
+		return (2 * v * m + d) / (2 * d);
+	}
+
+	/* rescale of every FROM-bit channel value to TO bits, e.g. unorm_table<5,8> for rgb565 expansion */
+	template<size_t FROM, size_t TO> requires (FROM > 0 && FROM <= 16 && TO <= 16)
+	static constexpr auto unorm_table = []()
+	{
+		std::array<std::conditional_t<(TO > 8), GLushort, GLubyte>, (size_t)1 << FROM> t{};
+		for(size_t v = 0; v < t.size(); v++)
+			t[v] = unorm_rescale(v, FROM, TO);
+		return t;
+	}();
+
 	/* bitfield color type with optional last component masked access because of missing zero width named bitfield */
 	template<fmt format>
 	struct bitfield_color
@@ -261,13 +1670,13 @@ namespace col
 		static constexpr const std::array<idx8<1>,4> bits   = format.second;
 		static constexpr const size_t                  size = std::bit_ceil((unsigned)std::accumulate(bits.begin(), bits.end(), 0));
 		static constexpr const size_t            components = std::count_if<bits.begin(), bits.end(), non_zero>;
-		using element_type = std::make_unsigned_t<__int_with_sizeof_t<std::bit_ceil((unsigned)*std::max_element(bits.begin(), bits.end()))/8>>;
+		using element_type = std::make_unsigned_t<__int_with_sizeof_t<std::max<size_t>(1, std::bit_ceil((unsigned)*std::max_element(bits.begin(), bits.end()))/8)>>;
 		using storage_type = std::make_unsigned_t<__int_with_sizeof_t<size/8>>;
 		static constexpr std::array<idx8<1>, 4>   shift = {   0  , bits[perm[col::r]], (bits[perm[col::r]] + bits[perm[col::g]]), (bits[perm[col::r]] + bits[perm[col::g]] + bits[perm[col::b]]) };
-		static constexpr std::array<storage_type, 4> mask = { ((1 << bits[perm[col::r]]) - 1) << 0,
-			((1 << bits[perm[col::g]]) - 1) <<  bits[perm[col::r]],
-			((1 << bits[perm[col::b]]) - 1) << (bits[perm[col::r]] + bits[perm[col::g]]),
-			((1 << bits[perm[col::a]]) - 1) << (bits[perm[col::r]] + bits[perm[col::g]] + bits[perm[col::b]]) };
+		static constexpr std::array<storage_type, 4> mask = { (((storage_type)1 << bits[perm[col::r]]) - 1) << 0,
+			(((storage_type)1 << bits[perm[col::g]]) - 1) <<  bits[perm[col::r]],
+			(((storage_type)1 << bits[perm[col::b]]) - 1) << (bits[perm[col::r]] + bits[perm[col::g]]),
+			(((storage_type)1 << bits[perm[col::a]]) - 1) << (bits[perm[col::r]] + bits[perm[col::g]] + bits[perm[col::b]]) };
 
 		union
 		{
@@ -279,35 +1688,46 @@ namespace col
 			};
 			storage_type c3;
 		};
-		bitfield_color(element_type r = 0, element_type g = 0, element_type b = 0, element_type a = 0) : c3(0)
+		constexpr bitfield_color(element_type r = 0, element_type g = 0, element_type b = 0, element_type a = 0) : c3(0)
 		{
 			set(col::r, r);
 			set(col::g, g);
 			set(col::b, b);
 			set(col::a, a);
 		}
+		/* normalized components clamped to [0,1], NaN to 0, and rounded to nearest like col::pack */
+		constexpr explicit bitfield_color(vec4f_t v) : c3(0)
+		{
+			for(size_t i = 0; i <= col::a; i++)
+			{
+				const vecf_t f = (v[i] > 0 ? v[i] < 1 ? v[i] : 1 : 0) * (((storage_type)1 << bits[perm[i]]) - 1);
+				const element_type q = f;
+				set(i, q + (f - q >= 0.5f));
+			}
+		}
+		/* 8-bit components rescaled to the channel depths */
+		constexpr explicit bitfield_color(byte_vec4_t v) : c3(0)
+		{
+			for(size_t i = 0; i <= col::a; i++)
+				if(bits[perm[i]] != 0)
+					set(i, unorm_rescale(v[i], 8, bits[perm[i]]));
+		}
 		inline constexpr         void set(size_t i, element_type val)
 		{
 			if(i == col::none) return;
 			if(i >= col::rgba)
 			{
 				for(uint8_t j = 0; j <= col::a; j++)
-					c3 |= (val << shift[perm[j]]) & mask[perm[j]];
+					c3 |= ((storage_type)val << shift[perm[j]]) & mask[perm[j]];
 				return;
 			}
-			c3 |= (val << shift[perm[i]]) & mask[perm[i]];
+			c3 |= ((storage_type)val << shift[perm[i]]) & mask[perm[i]];
 		}
 
+		/* through c3, constant evaluation can't read the bitfields of the inactive union member */
 		inline constexpr element_type get(size_t i) const
-		{ 
-			switch(perm[i])
-			{
-				case col::r: return c0; 
-				case col::g: return c1;
-				case col::b: return c2;
-				case col::a: return ((c3 & mask[col::a]) >> shift[col::a]);
-				default: return c3;
-			}
+		{
+			return (c3 & mask[perm[i]]) >> shift[perm[i]];
 		}
 		inline constexpr element_type operator[](size_t i) const { return get(i); }
 
@@ -316,19 +1736,27 @@ namespace col
 		inline constexpr element_type b() const { return get(col::b); }
 		inline constexpr element_type a() const { return get(col::a); }
 
+		/* normalized channel value, missing color channels read 0 and missing alpha reads 1 */
+		inline constexpr vecf_t norm(size_t i) const
+		{
+			if(bits[perm[i]] == 0)
+				return i == col::a ? 1 : 0;
+			return (vecf_t)get(i) / ((1 << bits[perm[i]]) - 1);
+		}
 		inline constexpr operator vec4f_t() const
 		{
-			return (vec4f_t)
-			{
-				(vecf_t)r() / ((1 << bits[perm[col::r]]) - 1),
-				(vecf_t)g() / ((1 << bits[perm[col::g]]) - 1),
-				(vecf_t)b() / ((1 << bits[perm[col::b]]) - 1),
-				(vecf_t)a() / ((1 << bits[perm[col::a]]) - 1)
-			};
+			return (vec4f_t){ norm(col::r), norm(col::g), norm(col::b), norm(col::a) };
+		}
+		/* channel i rescaled to 8 bits, missing color channels read 0 and missing alpha reads 255 */
+		inline constexpr type::u8<1> byte(size_t i) const
+		{
+			if(bits[perm[i]] == 0)
+				return i == col::a ? UINT8_MAX : 0;
+			return unorm_rescale(get(i), bits[perm[i]], 8);
 		}
 		inline constexpr operator byte_vec4_t() const
 		{
-			return ubroundf<4>(((vec4f_t)(*this)) * UINT8_MAX);
+			return (byte_vec4_t){ byte(col::r), byte(col::g), byte(col::b), byte(col::a) };
 		}
 	};
 
@@ -380,31 +1808,42 @@ do {									\
 
 #endif
 
-#ifndef __AVX__
-extern __inline __m256d __attribute__((__gnu_inline__, __always_inline__, __artificial__))
-_mm256_set_m128d     (__m128d __H, __m128d __L) { return (__m256d){ __L[0], __L[1], __H[0], __H[1] }; }
-extern __inline __m128d __attribute__((__gnu_inline__, __always_inline__, __artificial__))
-_mm256_extractf128_pd(__m256d __X, const int __N)   { return _mm_load_pd(&__X[(__N * 2) % 4]); }
-extern __inline __m256d __attribute__((__gnu_inline__, __always_inline__, __artificial__))
-_mm256_hadd_pd       (__m256d __X, __m256d __Y) { return (__m256d){ __X[0] + __X[1], __Y[0] + __Y[1], __X[2] + __X[3], __Y[2] + __Y[3] }; }
-#endif
-
 /* Component extract permute functions */
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select4_ps(__v4sf v, uint8_t i, uint8_t j, uint8_t k, uint8_t l) { return (__v4sf){v[i%4],v[j%4],v[k%4],v[l%4]}; }
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select3_ps(__v4sf v, uint8_t i, uint8_t j, uint8_t k) { return (__v4sf){v[i%4],v[j%4],v[k%4], 0}; }
-extern __inline __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select2_ps(__v4sf v, uint8_t i, uint8_t j) { return (__v2sf){v[i%4],v[j%4]}; }
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select4_pd(__v4df v, uint8_t i, uint8_t j, uint8_t k, uint8_t l) { return (__v4df){v[i%4],v[j%4],v[k%4],v[l%4]}; }
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select3_pd(__v4df v, uint8_t i, uint8_t j, uint8_t k) { return (__v4df){v[i%4],v[j%4],v[k%4], 0}; }
-extern __inline __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_select2_pd(__v4df v, uint8_t i, uint8_t j) { return (__v2df){v[i%4],v[j%4]}; }
 
+/* Component extract permute functions with compile-time indices, one shuffle each */
+template<uint8_t i, uint8_t j, uint8_t k, uint8_t l>
+inline constexpr __v4sf __attribute__((__always_inline__, __artificial__))
+_mm_select4_ps(__v4sf v) { return __builtin_shufflevector(v, v, i%4, j%4, k%4, l%4); }
+template<uint8_t i, uint8_t j, uint8_t k>
+inline constexpr __v4sf __attribute__((__always_inline__, __artificial__))
+_mm_select3_ps(__v4sf v) { return __builtin_shufflevector(v, (__v4sf){}, i%4, j%4, k%4, 4); }
+template<uint8_t i, uint8_t j>
+inline constexpr __v2sf __attribute__((__always_inline__, __artificial__))
+_mm_select2_ps(__v4sf v) { return __builtin_shufflevector(v, v, i%4, j%4); }
+template<uint8_t i, uint8_t j, uint8_t k, uint8_t l>
+inline constexpr __v4df __attribute__((__always_inline__, __artificial__))
+_mm_select4_pd(__v4df v) { return __builtin_shufflevector(v, v, i%4, j%4, k%4, l%4); }
+template<uint8_t i, uint8_t j, uint8_t k>
+inline constexpr __v4df __attribute__((__always_inline__, __artificial__))
+_mm_select3_pd(__v4df v) { return __builtin_shufflevector(v, (__v4df){}, i%4, j%4, k%4, 4); }
+template<uint8_t i, uint8_t j>
+inline constexpr __v2df __attribute__((__always_inline__, __artificial__))
+_mm_select2_pd(__v4df v) { return __builtin_shufflevector(v, v, i%4, j%4); }
+
 /* vec3<=>vec4 convert */
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_4to3_ps(__v4sf v, double w = 0)
 {
 	if(w != 0 && v[3] != 0)
@@ -412,7 +1851,7 @@ _mm_4to3_ps(__v4sf v, double w = 0)
 	return (__v4sf){ v[0], v[1], v[2], w };
 }
 
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_4to3_pd(__v4df v, double w = 0)
 {
 	if(w != 0 && v[3] != 0)
@@ -422,152 +1861,164 @@ _mm_4to3_pd(__v4df v, double w = 0)
 
 /* Dot product instructions with mask-defined summing and zeroing parts
    of result.  */
-extern __inline __m256d __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __m256d __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm256_dp_pd(__m256d __X, __m256d __Y, const int __M)
 {
-	__m256d cond  = { (__M & (1 << 4)) >> 4, (__M & (1 << 5)) >> 5, (__M & (1 << 6)) >> 6, (__M & (1 << 7)) >> 7};
-	__m256d broad = { (__M & (1 << 0)) >> 0, (__M & (1 << 1)) >> 1, (__M & (1 << 2)) >> 2, (__M & (1 << 3)) >> 3};
-	__m256d tmp = __X * __Y * cond;
-	tmp = _mm256_hadd_pd(tmp, tmp);
-	__m128d sum = _mm256_extractf128_pd(tmp, 0) + _mm256_extractf128_pd(tmp, 1);
-	return _mm256_set_m128d(sum, sum) * broad;
+	const __v4di bit = { 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+	__m256d tmp = (__m256d)((__v4di)(__X * __Y) & ((__M & bit) != 0));
+	tmp += __builtin_shufflevector(tmp, tmp, 1, 0, 3, 2);
+	tmp += __builtin_shufflevector(tmp, tmp, 2, 3, 0, 1);
+	return (__m256d)((__v4di)tmp & ((__M & (bit >> 4)) != 0));
+}
+
+/* Dot product with a compile-time mask, the summing and zeroing parts resolve to blends with zero */
+template<int __M>
+inline constexpr __m256d __attribute__((__always_inline__, __artificial__))
+_mm256_dp_pd(__m256d __X, __m256d __Y)
+{
+	__m256d tmp = __builtin_shufflevector(__X * __Y, (__m256d){}, __M & 0x10 ? 0 : 4, __M & 0x20 ? 1 : 5, __M & 0x40 ? 2 : 6, __M & 0x80 ? 3 : 7);
+	tmp += __builtin_shufflevector(tmp, tmp, 1, 0, 3, 2);
+	tmp += __builtin_shufflevector(tmp, tmp, 2, 3, 0, 1);
+	return __builtin_shufflevector(tmp, (__m256d){}, __M & 0x1 ? 0 : 4, __M & 0x2 ? 1 : 5, __M & 0x4 ? 2 : 6, __M & 0x8 ? 3 : 7);
 }
 
-extern __inline __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
-_mm_laplace2_ps(__v2sf __X) { return (__v2sf){ __X[1], __X[0] }; }
-extern __inline __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
-_mm_laplace2_pd(__v2df __X) { return (__v2df){ __X[1], __X[0] }; }
+extern __inline constexpr __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_laplace2_ps(__v2sf __X) { return __builtin_shufflevector(__X, __X, 1, 0); }
+extern __inline constexpr __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_laplace2_pd(__v2df __X) { return __builtin_shufflevector(__X, __X, 1, 0); }
 
-extern __inline float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det2_ps(__v2sf a, __v2sf b)
 {
 	__v2sf dst = (__v2sf){ 1, -1 } * a * _mm_laplace2_ps(b);
 	return dst[0] + dst[1];
 }
-extern __inline double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det2_pd(__v2df a, __v2df b)
 {
 	__v2df dst = (__v2df){ 1, -1 } * a * _mm_laplace2_pd(b);
 	return dst[0] + dst[1];
 }
 
-extern __inline __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_neg2_ps(__v2sf __X, uint8_t mod = 2, uint8_t val = 0)
 {
 	return (__v2sf){ (0 % mod == val) ? -__X[0] : __X[0],
 	                 (1 % mod == val) ? -__X[1] : __X[1] };
 }
 
-extern __inline __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_neg2_pd(__v2df __X, uint8_t mod = 2, uint8_t val = 0)
 {
 	return (__v2df) { (0 % mod == val) ? -__X[0] : __X[0],
 	                  (1 % mod == val) ? -__X[1] : __X[1] };
 }
 
-extern __inline __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross2_ps(__v2sf a, unsigned int winding = GL_CCW)
 {
 	return _mm_neg2_ps((__v2sf){1, 1}, 2, 1 - (winding % 2)) * _mm_laplace2_ps(a);
 }
 
-extern __inline __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v2df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross2_pd(__v2df a, unsigned int winding = GL_CCW)
 {
 	return _mm_neg2_pd((__v2df){1, 1}, 2, 1 - (winding % 2)) * _mm_laplace2_pd(a);
 }
 
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_laplace3_ps(__v4sf __X, __v4sf __Y)
 {
-	__v4sf dst  = { _mm_det2_ps(_mm_select2_ps(__X,1,2), _mm_select2_ps(__Y,1,2)),
-	                _mm_det2_ps(_mm_select2_ps(__X,0,2), _mm_select2_ps(__Y,0,2)),
-	                _mm_det2_ps(_mm_select2_ps(__X,0,1), _mm_select2_ps(__Y,0,1)),
-		        0
-		      };
-	return dst;
+	return _mm_select3_ps<1,0,0>(__X) * _mm_select3_ps<2,2,1>(__Y) - _mm_select3_ps<2,2,1>(__X) * _mm_select3_ps<1,0,0>(__Y);
 }
 
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_laplace3_pd(__v4df __X, __v4df __Y)
 {
-	__v4df dst  = { _mm_det2_pd(_mm_select2_pd(__X,1,2), _mm_select2_pd(__Y,1,2)),
-	                _mm_det2_pd(_mm_select2_pd(__X,0,2), _mm_select2_pd(__Y,0,2)),
-	                _mm_det2_pd(_mm_select2_pd(__X,0,1), _mm_select2_pd(__Y,0,1)),
-		        0
-		      };
-	return dst;
+	return _mm_select3_pd<1,0,0>(__X) * _mm_select3_pd<2,2,1>(__Y) - _mm_select3_pd<2,2,1>(__X) * _mm_select3_pd<1,0,0>(__Y);
 }
 
-extern __inline float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det3_ps(__v4sf a, __v4sf b, __v4sf c)
 {
 	__v4sf dst = (__v4sf){1, -1, 1, 0} * a * _mm_laplace3_ps(b, c);
 	return dst[0] + dst[1] + dst[2];
 }
 
-extern __inline double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det3_pd(__v4df a, __v4df b, __v4df c)
 {
 	__v4df dst = (__v4df){1, -1, 1, 0} * a * _mm_laplace3_pd(b, c);
 	return dst[0] + dst[1] + dst[2];
 }
 
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross3_ps(__v4sf a, __v4sf b)
 {
-	return (__v4sf){1, -1, 1, 0} * _mm_laplace3_ps(a, b);
+	return _mm_select3_ps<1,2,0>(a) * _mm_select3_ps<2,0,1>(b) - _mm_select3_ps<2,0,1>(a) * _mm_select3_ps<1,2,0>(b);
 }
 
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross3_pd(__v4df a, __v4df b)
 {
-	return (__v4df){1, -1, 1, 0} * _mm_laplace3_pd(a, b);
+	return _mm_select3_pd<1,2,0>(a) * _mm_select3_pd<2,0,1>(b) - _mm_select3_pd<2,0,1>(a) * _mm_select3_pd<1,2,0>(b);
 }
 
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_laplace4_ps(__v4sf __X, __v4sf __Y, __v4sf __Z)
 {
-	__v4sf dst  = { _mm_det3_ps(_mm_select3_ps(__X,1,2,3), _mm_select3_ps(__Y,1,2,3), _mm_select3_ps(__Z,1,2,3)), 
-	                _mm_det3_ps(_mm_select3_ps(__X,0,2,3), _mm_select3_ps(__Y,0,2,3), _mm_select3_ps(__Z,0,2,3)),
-	                _mm_det3_ps(_mm_select3_ps(__X,0,1,3), _mm_select3_ps(__Y,0,1,3), _mm_select3_ps(__Z,0,1,3)),
-		        _mm_det3_ps(_mm_select3_ps(__X,0,1,2), _mm_select3_ps(__Y,0,1,2), _mm_select3_ps(__Z,0,1,2))
+	__v4sf dst  = { _mm_det3_ps(_mm_select3_ps<1,2,3>(__X), _mm_select3_ps<1,2,3>(__Y), _mm_select3_ps<1,2,3>(__Z)),
+	                _mm_det3_ps(_mm_select3_ps<0,2,3>(__X), _mm_select3_ps<0,2,3>(__Y), _mm_select3_ps<0,2,3>(__Z)),
+	                _mm_det3_ps(_mm_select3_ps<0,1,3>(__X), _mm_select3_ps<0,1,3>(__Y), _mm_select3_ps<0,1,3>(__Z)),
+		        _mm_det3_ps(_mm_select3_ps<0,1,2>(__X), _mm_select3_ps<0,1,2>(__Y), _mm_select3_ps<0,1,2>(__Z))
 		      };
 	return dst;
 }
 
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_laplace4_pd(__v4df __X, __v4df __Y, __v4df __Z)
 {
-	__v4df dst  = { _mm_det3_pd(_mm_select3_pd(__X,1,2,3), _mm_select3_pd(__Y,1,2,3), _mm_select3_pd(__Z,1,2,3)), 
-	                _mm_det3_pd(_mm_select3_pd(__X,0,2,3), _mm_select3_pd(__Y,0,2,3), _mm_select3_pd(__Z,0,2,3)),
-	                _mm_det3_pd(_mm_select3_pd(__X,0,1,3), _mm_select3_pd(__Y,0,1,3), _mm_select3_pd(__Z,0,1,3)),
-		        _mm_det3_pd(_mm_select3_pd(__X,0,1,2), _mm_select3_pd(__Y,0,1,2), _mm_select3_pd(__Z,0,1,2))
+	__v4df dst  = { _mm_det3_pd(_mm_select3_pd<1,2,3>(__X), _mm_select3_pd<1,2,3>(__Y), _mm_select3_pd<1,2,3>(__Z)),
+	                _mm_det3_pd(_mm_select3_pd<0,2,3>(__X), _mm_select3_pd<0,2,3>(__Y), _mm_select3_pd<0,2,3>(__Z)),
+	                _mm_det3_pd(_mm_select3_pd<0,1,3>(__X), _mm_select3_pd<0,1,3>(__Y), _mm_select3_pd<0,1,3>(__Z)),
+		        _mm_det3_pd(_mm_select3_pd<0,1,2>(__X), _mm_select3_pd<0,1,2>(__Y), _mm_select3_pd<0,1,2>(__Z))
 		      };
 	return dst;
 }
 
-extern __inline float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det4_ps(__v4sf a, __v4sf b, __v4sf c, __v4sf d)
 {
-	__v4sf dst = (__v4sf){1, -1, 1, -1} * a * _mm_laplace4_ps(b, c, d);
-	return dst[0] + dst[1] + dst[2] + dst[3];
+	return id::math::type::cofactor4<false>(a, b, c, d)[0];
 }
 
-extern __inline double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+/* In-place 4x4 inverse of rows a-d, returns the determinant */
+extern __inline constexpr float __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_inverse4_ps(__v4sf& a, __v4sf& b, __v4sf& c, __v4sf& d)
+{
+	return id::math::type::cofactor4<true>(a, b, c, d)[0];
+}
+
+extern __inline constexpr double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_det4_pd(__v4df a, __v4df b, __v4df c, __v4df d)
 {
-	__v4df dst = (__v4df){1, -1, 1, -1} * a * _mm_laplace4_pd(b, c, d);
-	return dst[0] + dst[1] + dst[2] + dst[3];
+	return id::math::type::cofactor4<false>(a, b, c, d)[0];
+}
+
+/* In-place 4x4 inverse of rows a-d, returns the determinant */
+extern __inline constexpr double __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_inverse4_pd(__v4df& a, __v4df& b, __v4df& c, __v4df& d)
+{
+	return id::math::type::cofactor4<true>(a, b, c, d)[0];
 }
 
-extern __inline __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4sf __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross4_ps(__v4sf a, __v4sf b, __v4sf c)
 {
 	return (__v4sf){-1, 1, -1, 1} * _mm_laplace4_ps(a, b, c);
 }
 
-extern __inline __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+extern __inline constexpr __v4df __attribute__((__gnu_inline__, __always_inline__, __artificial__))
 _mm_cross4_pd(__v4df a, __v4df b, __v4df c)
 { 
 	return (__v4df){-1, 1, -1, 1} * _mm_laplace4_pd(a, b, c);
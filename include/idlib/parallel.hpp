@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <idlib/math.hpp>
+
+namespace id::math::type
+{
+	/* how a batch is split across threads, threads 0 is the hardware concurrency and chunk 0 sizes the chunks so that
+	   the elements of one fit the L2 cache, other chunks are rounded up to parallel_chunk_align */
+	struct parallel_policy
+	{
+		size_t threads = 0;
+		size_t chunk = 0;
+	};
+
+	static constexpr parallel_policy seq = { 1 };
+	static constexpr parallel_policy par = {};
+
+	/* bytes of the per thread cache the default chunk fills, and the element multiple chunks are rounded to so that
+	   SIMD tails only occur at the end of a batch and 64-bit masks of one bit per element split on word boundaries */
+	static constexpr size_t parallel_chunk_bytes = 256 << 10;
+	static constexpr size_t parallel_chunk_align = 64;
+
+	/* persistent workers shared by every parallel call, started on first use and grown to the most threads a call asked
+	   for. a job runs on the caller and threads - 1 workers, each owns a contiguous range of the chunks and takes them
+	   front to back, then steals what is left of the others. calls from inside a job run inline, concurrent calls from
+	   other threads take turns */
+	class thread_pool
+	{
+		/* next and end chunk of the range of one participant, a cache line each */
+		struct alignas(64) range
+		{
+			std::atomic<size_t> next;
+			size_t end;
+		};
+
+		struct job
+		{
+			void (*call)(void*, size_t, size_t);
+			void* f;
+			size_t n, chunk, participants;
+			range* ranges;
+		};
+
+		std::vector<std::jthread> workers;
+		std::mutex lock, turn, failing;
+		std::exception_ptr error;
+		std::condition_variable wake;
+		const job* current = nullptr;
+		size_t generation = 0;
+		bool stopping = false;
+		std::atomic<size_t> active = 0;
+
+		static inline thread_local bool inside = false;
+
+		void work(const job& j, size_t p)
+		{
+			try
+			{
+				for(size_t k = 0; k < j.participants; k++)
+				{
+					range& r = j.ranges[(p + k) % j.participants];
+					for(size_t c; (c = r.next.fetch_add(1, std::memory_order_relaxed)) < r.end;)
+						j.call(j.f, c * j.chunk, std::min(j.n, (c + 1) * j.chunk));
+				}
+			}
+			catch(...)
+			{
+				/* the first exception is rethrown on the caller once every participant stopped, chunks not started
+				   yet are dropped */
+				{
+					std::lock_guard l(failing);
+					if(!error)
+						error = std::current_exception();
+				}
+				for(size_t k = 0; k < j.participants; k++)
+					j.ranges[k].next.store(j.ranges[k].end, std::memory_order_relaxed);
+			}
+		}
+
+		void loop(size_t id)
+		{
+			inside = true;
+			size_t seen = 0;
+			for(;;)
+			{
+				job j = {};
+				{
+					std::unique_lock l(lock);
+					wake.wait(l, [&] { return stopping || generation != seen; });
+					if(stopping)
+						return;
+					seen = generation;
+					/* a job already finished by the others is gone */
+					if(current)
+						j = *current;
+				}
+				if(id + 1 < j.participants)
+				{
+					work(j, id + 1);
+					if(active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						active.notify_one();
+				}
+			}
+		}
+
+	public:
+		thread_pool() = default;
+		thread_pool(const thread_pool&) = delete;
+		~thread_pool()
+		{
+			{
+				std::lock_guard l(lock);
+				stopping = true;
+			}
+			wake.notify_all();
+		}
+
+		static thread_pool& instance()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+
+		/* hardware threads, the default thread count of a job */
+		static size_t concurrency()
+		{
+			static const size_t n = std::max(1u, std::thread::hardware_concurrency());
+			return n;
+		}
+
+		/* f(first, last) over [0, n) in chunks of chunk elements on up to threads threads, returns once all ran, an
+		   exception thrown by f on any thread is rethrown here after the others finished their chunks in progress */
+		template<typename F>
+		void run(size_t n, size_t chunk, size_t threads, F& f)
+		{
+			const size_t chunks = (n + chunk - 1) / chunk;
+			threads = std::min(threads, chunks);
+			if(threads <= 1 || inside)
+			{
+				for(size_t c = 0; c < chunks; c++)
+					f(c * chunk, std::min(n, (c + 1) * chunk));
+				return;
+			}
+
+			std::lock_guard t(turn);
+			{
+				std::lock_guard l(lock);
+				while(workers.size() + 1 < threads)
+					workers.emplace_back([this, id = workers.size()] { loop(id); });
+			}
+
+			std::unique_ptr<range[]> ranges(new range[threads]);
+			for(size_t p = 0; p < threads; p++)
+			{
+				ranges[p].next.store(chunks * p / threads, std::memory_order_relaxed);
+				ranges[p].end = chunks * (p + 1) / threads;
+			}
+			const job j = { [](void* f, size_t first, size_t last) { (*(F*)f)(first, last); }, &f, n, chunk, threads, ranges.get() };
+
+			active.store(threads - 1, std::memory_order_relaxed);
+			{
+				std::lock_guard l(lock);
+				current = &j;
+				generation++;
+			}
+			wake.notify_all();
+
+			inside = true;
+			work(j, 0);
+			inside = false;
+			for(size_t a; (a = active.load(std::memory_order_acquire)) != 0;)
+				active.wait(a, std::memory_order_acquire);
+			{
+				std::lock_guard l(lock);
+				current = nullptr;
+			}
+			if(std::exception_ptr e = std::exchange(error, nullptr))
+				std::rethrow_exception(e);
+		}
+	};
+
+	/* f(first, last) over [0, n) split into chunks across threads by the policy, bytes is the memory one element
+	   touches and sizes the default chunk. a batch of a single chunk or a single thread runs inline on the caller.
+	   chunk boundaries only depend on n and the policy so every element is processed by exactly one call no matter
+	   which thread takes it, outputs written by element index come out the same as a sequential run. the chunks of a
+	   thread are contiguous, pages first touched through the same split stay local to it on NUMA systems */
+	template<typename F>
+	void parallel_for(const parallel_policy& policy, size_t n, size_t bytes, F&& f)
+	{
+		if(n == 0)
+			return;
+		size_t chunk = (policy.chunk + parallel_chunk_align - 1) / parallel_chunk_align * parallel_chunk_align;
+		if(chunk == 0)
+			chunk = std::max<size_t>(parallel_chunk_align, parallel_chunk_bytes / std::max<size_t>(bytes, 1) / parallel_chunk_align * parallel_chunk_align);
+		const size_t threads = policy.threads ? policy.threads : thread_pool::concurrency();
+		if(n <= chunk || threads == 1)
+		{
+			f(size_t(0), n);
+			return;
+		}
+		thread_pool::instance().run(n, chunk, threads, f);
+	}
+
+	/* element wise span kernel k over equally indexed spans split by the policy, k gets the subspans of one chunk and
+	   returns its count, e.g. parallel(par, [](auto s, auto d) { return normalize<precision::fast, float>(s, d); },
+	   src, dst). returns the summed counts */
+	template<typename K, typename... S>
+	size_t parallel(const parallel_policy& policy, K&& k, S... spans)
+	{
+		const size_t n = std::min({ spans.size()... });
+		std::atomic<size_t> count = 0;
+		parallel_for(policy, n, (sizeof(typename S::element_type) + ...), [&](size_t first, size_t last)
+		{
+			count.fetch_add(k(spans.subspan(first, last - first)...), std::memory_order_relaxed);
+		});
+		return count.load(std::memory_order_relaxed);
+	}
+};
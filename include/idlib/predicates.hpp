@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cmath>
+#include <span>
+#include <tuple>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+
+namespace id::math::type
+{
+	/* exact double expansion arithmetic after Shewchuk, a value is the sum of nonoverlapping components held in
+	   increasing magnitude with zeros eliminated, the last component carries the sign */
+	namespace exact
+	{
+		/* at most N components */
+		template<size_t N>
+		struct expansion
+		{
+			std::array<double,N> e;
+			size_t n = 0;
+
+			int sign() const { return e[n - 1] > 0 ? 1 : e[n - 1] < 0 ? -1 : 0; }
+		};
+
+		/* x + y = a + b exactly, x = fl(a + b), |a| >= |b| */
+		inline void fast_two_sum(double a, double b, double& x, double& y) { x = a + b; y = b - (x - a); }
+
+		/* x + y = a + b exactly, x = fl(a + b) */
+		inline void two_sum(double a, double b, double& x, double& y)
+		{
+			x = a + b;
+			double bv = x - a, av = x - bv;
+			y = (a - av) + (b - bv);
+		}
+
+		/* x + y = a * b exactly, x = fl(a * b) */
+		inline void two_product(double a, double b, double& x, double& y) { x = a * b; y = std::fma(a, b, -x); }
+
+		/* a - b as a two component expansion */
+		inline expansion<2> diff(double a, double b)
+		{
+			double x = a - b, bv = a - x, av = x + bv;
+			expansion<2> h;
+			h.e[0] = (a - av) + (bv - b);
+			h.e[1] = x;
+			h.n = h.e[0] != 0 ? 2 : 1;
+			if(h.n == 1)
+				h.e[0] = x;
+			return h;
+		}
+
+		/* e + s f through the merge based fast expansion sum, s = -1 subtracts */
+		template<size_t M, size_t N>
+		inline expansion<M + N> sum(const expansion<M>& e, const expansion<N>& f, double s = 1)
+		{
+			expansion<M + N> h;
+			size_t i = 0, j = 0;
+			auto next = [&]
+			{
+				double a = i < e.n ? e.e[i] : 0, b = j < f.n ? s * f.e[j] : 0;
+				if(j == f.n || (i < e.n && (b > a) == (b > -a)))
+					return i++, a;
+				return j++, b;
+			};
+			double q = next(), x, y;
+			if(i < e.n && j < f.n)
+			{
+				fast_two_sum(next(), q, x, y);
+				q = x;
+				if(y != 0)
+					h.e[h.n++] = y;
+			}
+			while(i + j < e.n + f.n)
+			{
+				two_sum(q, next(), x, y);
+				q = x;
+				if(y != 0)
+					h.e[h.n++] = y;
+			}
+			if(q != 0 || h.n == 0)
+				h.e[h.n++] = q;
+			return h;
+		}
+
+		/* e b */
+		template<size_t M>
+		inline expansion<2 * M> scale(const expansion<M>& e, double b)
+		{
+			expansion<2 * M> h;
+			double q, y, p1, p0, t;
+			two_product(e.e[0], b, q, y);
+			if(y != 0)
+				h.e[h.n++] = y;
+			for(size_t i = 1; i < e.n; i++)
+			{
+				two_product(e.e[i], b, p1, p0);
+				two_sum(q, p0, t, y);
+				if(y != 0)
+					h.e[h.n++] = y;
+				fast_two_sum(p1, t, q, y);
+				if(y != 0)
+					h.e[h.n++] = y;
+			}
+			if(q != 0 || h.n == 0)
+				h.e[h.n++] = q;
+			return h;
+		}
+
+		/* e f as the sum of e scaled by every component of f */
+		template<size_t M, size_t N>
+		inline expansion<2 * M * N> mul(const expansion<M>& e, const expansion<N>& f)
+		{
+			expansion<2 * M * N> h;
+			expansion<2 * M> p = scale(e, f.e[0]);
+			std::copy_n(p.e.begin(), p.n, h.e.begin());
+			h.n = p.n;
+			for(size_t j = 1; j < f.n; j++)
+			{
+				expansion<2 * M * N + 2 * M> s = sum(h, scale(e, f.e[j]));
+				std::copy_n(s.e.begin(), s.n, h.e.begin());
+				h.n = s.n;
+			}
+			return h;
+		}
+
+		/* ad - bc */
+		template<size_t N>
+		inline expansion<4 * N * N> det2(const expansion<N>& a, const expansion<N>& b, const expansion<N>& c, const expansion<N>& d)
+		{
+			return sum(mul(a, d), mul(b, c), -1);
+		}
+
+		/* v scaled by the power of two that brings its largest magnitude into [0.5, 1), exact and sign preserving for
+		   the homogeneous predicates, keeps the products of tiny or huge coordinates from underflowing or overflowing */
+		template<size_t N>
+		inline std::array<double,N> rescale(std::array<double,N> v)
+		{
+			double m = 0;
+			for(double x : v)
+				m = std::max(m, std::abs(x));
+			if(m == 0 || !std::isfinite(m))
+				return v;
+			int e;
+			std::frexp(m, &e);
+			for(double& x : v)
+				x = std::ldexp(x, -e);
+			return v;
+		}
+
+		/* the predicates below are exact as long as, relative to the largest coordinate, the lowest set bit of every
+		   coordinate lies within 2^500 for orient2d, 2^350 for orient3d and 2^260 for incircle, so that no partial
+		   product of the rescaled coordinates underflows */
+		inline int orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+		{
+			std::tie(ax, ay, bx, by, cx, cy) = std::tuple_cat(rescale<6>({ ax, ay, bx, by, cx, cy }));
+			return det2(diff(ax, cx), diff(ay, cy), diff(bx, cx), diff(by, cy)).sign();
+		}
+
+		inline int orient3d(double ax, double ay, double az, double bx, double by, double bz,
+		                    double cx, double cy, double cz, double dx, double dy, double dz)
+		{
+			std::tie(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz) = std::tuple_cat(rescale<12>({ ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz }));
+			auto adx = diff(ax, dx), ady = diff(ay, dy), adz = diff(az, dz);
+			auto bdx = diff(bx, dx), bdy = diff(by, dy), bdz = diff(bz, dz);
+			auto cdx = diff(cx, dx), cdy = diff(cy, dy), cdz = diff(cz, dz);
+			auto a = mul(adx, det2(bdy, bdz, cdy, cdz));
+			auto b = mul(bdx, det2(cdy, cdz, ady, adz));
+			auto c = mul(cdx, det2(ady, adz, bdy, bdz));
+			return sum(sum(a, b), c).sign();
+		}
+
+		inline int incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+		{
+			std::tie(ax, ay, bx, by, cx, cy, dx, dy) = std::tuple_cat(rescale<8>({ ax, ay, bx, by, cx, cy, dx, dy }));
+			auto adx = diff(ax, dx), ady = diff(ay, dy);
+			auto bdx = diff(bx, dx), bdy = diff(by, dy);
+			auto cdx = diff(cx, dx), cdy = diff(cy, dy);
+			auto a = mul(sum(mul(adx, adx), mul(ady, ady)), det2(bdx, bdy, cdx, cdy));
+			auto b = mul(sum(mul(bdx, bdx), mul(bdy, bdy)), det2(cdx, cdy, adx, ady));
+			auto c = mul(sum(mul(cdx, cdx), mul(cdy, cdy)), det2(adx, ady, bdx, bdy));
+			return sum(sum(a, b), c).sign();
+		}
+	};
+
+	/* error bound b of a filter, infinite where it is so small that terms may have underflowed and the bound no longer
+	   covers their error, those lanes are decided by the exact stage */
+	template<typename V, typename E>
+	inline __attribute__((__always_inline__)) V underflow_guard(V b)
+	{
+		static constexpr E tiny = std::numeric_limits<E>::min() / std::numeric_limits<E>::epsilon();
+		return b < tiny ? b * 0 + std::numeric_limits<E>::infinity() : b;
+	}
+
+	/* determinant and static error bound of the orientation of a b c in the element precision, Shewchuk's first
+	   stage bound scaled by the permanent, V is a scalar or a packet lane vector */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::pair<V,V> orient2d_filter(const std::array<V,2>& a, const std::array<V,2>& b, const std::array<V,2>& c)
+	{
+		using E = decltype([] { if constexpr(sca<V>) return V{}; else return V{}[0]; }());
+		static constexpr E eps = std::numeric_limits<E>::epsilon() / 2, bound = (3 + 16 * eps) * eps;
+		V l = (a[0] - c[0]) * (b[1] - c[1]), r = (a[1] - c[1]) * (b[0] - c[0]);
+		V p = (l < 0 ? -l : l) + (r < 0 ? -r : r);
+		return { l - r, underflow_guard<V,E>(bound * p) };
+	}
+
+	/* orient3d determinant and static error bound */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::pair<V,V> orient3d_filter(const std::array<V,3>& a, const std::array<V,3>& b, const std::array<V,3>& c, const std::array<V,3>& d)
+	{
+		using E = decltype([] { if constexpr(sca<V>) return V{}; else return V{}[0]; }());
+		static constexpr E eps = std::numeric_limits<E>::epsilon() / 2, bound = (7 + 56 * eps) * eps;
+		auto abs = [](V v) { return v < 0 ? -v : v; };
+		V adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+		V bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+		V cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+		V bc = bdx * cdy, cb = cdx * bdy, ca = cdx * ady, ac = adx * cdy, ab = adx * bdy, ba = bdx * ady;
+		V det = adz * (bc - cb) + bdz * (ca - ac) + cdz * (ab - ba);
+		V p = (abs(bc) + abs(cb)) * abs(adz) + (abs(ca) + abs(ac)) * abs(bdz) + (abs(ab) + abs(ba)) * abs(cdz);
+		return { det, underflow_guard<V,E>(bound * p) };
+	}
+
+	/* incircle determinant and static error bound */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::pair<V,V> incircle_filter(const std::array<V,2>& a, const std::array<V,2>& b, const std::array<V,2>& c, const std::array<V,2>& d)
+	{
+		using E = decltype([] { if constexpr(sca<V>) return V{}; else return V{}[0]; }());
+		static constexpr E eps = std::numeric_limits<E>::epsilon() / 2, bound = (10 + 96 * eps) * eps;
+		auto abs = [](V v) { return v < 0 ? -v : v; };
+		V adx = a[0] - d[0], ady = a[1] - d[1];
+		V bdx = b[0] - d[0], bdy = b[1] - d[1];
+		V cdx = c[0] - d[0], cdy = c[1] - d[1];
+		V bc = bdx * cdy, cb = cdx * bdy, ca = cdx * ady, ac = adx * cdy, ab = adx * bdy, ba = bdx * ady;
+		V al = adx * adx + ady * ady, bl = bdx * bdx + bdy * bdy, cl = cdx * cdx + cdy * cdy;
+		V det = al * (bc - cb) + bl * (ca - ac) + cl * (ab - ba);
+		V p = (abs(bc) + abs(cb)) * al + (abs(ca) + abs(ac)) * bl + (abs(ab) + abs(ba)) * cl;
+		return { det, underflow_guard<V,E>(bound * p) };
+	}
+
+	/* signs of W filtered determinants into dst, lanes within the error bound are decided by exact(l) */
+	template<size_t W, typename V, typename F>
+	inline __attribute__((__always_inline__)) void store_signs(V det, V bound, i8<1>* dst, F&& exact)
+	{
+		storeu(dst, __builtin_convertvector((det < 0) - (det > 0), vector_aligned<i8<1>,W>));
+		for(u64<1> m = lane_bits(~((det < 0 ? -det : det) > bound)); m; m &= m - 1)
+			dst[std::countr_zero(m)] = exact(std::countr_zero(m));
+	}
+
+	/* sign of the orientation of a b c, 1 counterclockwise, -1 clockwise and 0 collinear, exact within the range of
+	   exponents the exact stage covers, see exact::orient2d */
+	template<sca T>
+	inline int orient2d(const vec<T,2>& a, const vec<T,2>& b, const vec<T,2>& c)
+	{
+		auto [det, bound] = orient2d_filter<T>({ a[0], a[1] }, { b[0], b[1] }, { c[0], c[1] });
+		if(det > bound || -det > bound)
+			return det > 0 ? 1 : -1;
+		return exact::orient2d(a[0], a[1], b[0], b[1], c[0], c[1]);
+	}
+
+	/* sign of the orientation of d against the plane through a b c, 1 when d lies below it with a b c counterclockwise
+	   seen from above, -1 above and 0 coplanar */
+	template<sca T>
+	inline int orient3d(const vec<T,3>& a, const vec<T,3>& b, const vec<T,3>& c, const vec<T,3>& d)
+	{
+		auto [det, bound] = orient3d_filter<T>(a, b, c, d);
+		if(det > bound || -det > bound)
+			return det > 0 ? 1 : -1;
+		return exact::orient3d(a[0], a[1], a[2], b[0], b[1], b[2], c[0], c[1], c[2], d[0], d[1], d[2]);
+	}
+
+	/* 1 when d lies inside the circle through the counterclockwise a b c, -1 outside and 0 on it */
+	template<sca T>
+	inline int incircle(const vec<T,2>& a, const vec<T,2>& b, const vec<T,2>& c, const vec<T,2>& d)
+	{
+		auto [det, bound] = incircle_filter<T>({ a[0], a[1] }, { b[0], b[1] }, { c[0], c[1] }, { d[0], d[1] });
+		if(det > bound || -det > bound)
+			return det > 0 ? 1 : -1;
+		return exact::incircle(a[0], a[1], b[0], b[1], c[0], c[1], d[0], d[1]);
+	}
+
+	/* batched orient2d, dst[i] = orient2d(a[i], b[i], c[i]) with the filter running on whole packets of point sets,
+	   returns the number of signs */
+	template<sca T>
+	size_t orient2d(std::span<const vec<T,2>> a, std::span<const vec<T,2>> b, std::span<const vec<T,2>> c, std::span<i8<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min({ a.size(), b.size(), c.size(), dst.size() });
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+			{
+				auto [det, bound] = orient2d_filter(gather<T,2,W>(&a[i]), gather<T,2,W>(&b[i]), gather<T,2,W>(&c[i]));
+				store_signs<W>(det, bound, &dst[i], [&](size_t l)
+				{
+					return exact::orient2d(a[i + l][0], a[i + l][1], b[i + l][0], b[i + l][1], c[i + l][0], c[i + l][1]);
+				});
+			}
+			for(; i < len; i++)
+				dst[i] = orient2d<T>(a[i], b[i], c[i]);
+			return len;
+		});
+	}
+
+	/* batched orient3d */
+	template<sca T>
+	size_t orient3d(std::span<const vec<T,3>> a, std::span<const vec<T,3>> b, std::span<const vec<T,3>> c, std::span<const vec<T,3>> d, std::span<i8<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min({ a.size(), b.size(), c.size(), d.size(), dst.size() });
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+			{
+				auto [det, bound] = orient3d_filter(gather<T,3,W>(&a[i]), gather<T,3,W>(&b[i]), gather<T,3,W>(&c[i]), gather<T,3,W>(&d[i]));
+				store_signs<W>(det, bound, &dst[i], [&](size_t l)
+				{
+					const size_t k = i + l;
+					return exact::orient3d(a[k][0], a[k][1], a[k][2], b[k][0], b[k][1], b[k][2], c[k][0], c[k][1], c[k][2], d[k][0], d[k][1], d[k][2]);
+				});
+			}
+			for(; i < len; i++)
+				dst[i] = orient3d<T>(a[i], b[i], c[i], d[i]);
+			return len;
+		});
+	}
+
+	/* batched incircle */
+	template<sca T>
+	size_t incircle(std::span<const vec<T,2>> a, std::span<const vec<T,2>> b, std::span<const vec<T,2>> c, std::span<const vec<T,2>> d, std::span<i8<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min({ a.size(), b.size(), c.size(), d.size(), dst.size() });
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+			{
+				auto [det, bound] = incircle_filter(gather<T,2,W>(&a[i]), gather<T,2,W>(&b[i]), gather<T,2,W>(&c[i]), gather<T,2,W>(&d[i]));
+				store_signs<W>(det, bound, &dst[i], [&](size_t l)
+				{
+					const size_t k = i + l;
+					return exact::incircle(a[k][0], a[k][1], b[k][0], b[k][1], c[k][0], c[k][1], d[k][0], d[k][1]);
+				});
+			}
+			for(; i < len; i++)
+				dst[i] = incircle<T>(a[i], b[i], c[i], d[i]);
+			return len;
+		});
+	}
+};
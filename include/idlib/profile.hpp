@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(IDLIB_PROFILE)
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#if defined(IDLIB_PROFILE_PERF) && __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IDLIB_PROFILE_HAVE_PERF 1
+#endif
+#endif
+
+namespace id::math::type
+{
+	/* opt-in instrumentation of the batch kernels, built with IDLIB_PROFILE every simd_dispatch records the calls,
+	   elements and cycles of the kernel it runs for, keyed by the calling function. without it the dispatch is
+	   unchanged and the functions below report nothing */
+#if defined(IDLIB_PROFILE)
+	static constexpr bool profile_enabled = true;
+#else
+	static constexpr bool profile_enabled = false;
+#endif
+
+	/* histogram buckets, bucket b counts the calls that took [2^b, 2^(b + 1)) cycles, bucket 0 also those of 0 */
+	static constexpr size_t profile_buckets = 32;
+
+	/* totals of one kernel over all threads, elements are the counts returned by kernels that return one */
+	struct profile_entry
+	{
+		std::string kernel;
+		uint64_t calls = 0;
+		uint64_t elements = 0;
+		uint64_t cycles = 0;
+		std::array<uint64_t, profile_buckets> histogram = {};
+	};
+
+#if defined(IDLIB_PROFILE)
+	/* cycle source, core cycles of the calling thread through perf_event with IDLIB_PROFILE_PERF on Linux at the
+	   cost of a read syscall per sample, the time stamp counter otherwise and nanoseconds off x86 */
+	inline const char* profile_clock_source()
+	{
+#if defined(IDLIB_PROFILE_HAVE_PERF)
+		return "perf_event";
+#elif defined(__x86_64__) || defined(__i386__)
+		return "rdtsc";
+#else
+		return "ns";
+#endif
+	}
+
+#if defined(IDLIB_PROFILE_HAVE_PERF)
+	/* perf_event core cycle counter of the calling thread, -1 where the kernel refuses it and rdtsc is used instead */
+	inline int profile_perf_fd()
+	{
+		static thread_local const int fd = []()
+		{
+			perf_event_attr attr = {};
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		}();
+		return fd;
+	}
+#endif
+
+	inline __attribute__((__always_inline__)) uint64_t profile_clock()
+	{
+#if defined(IDLIB_PROFILE_HAVE_PERF)
+		uint64_t v;
+		if(const int fd = profile_perf_fd(); fd >= 0 && read(fd, &v, sizeof(v)) == sizeof(v))
+			return v;
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	/* counters of one thread in a fixed open addressed table keyed by the address of the function name, written by
+	   the owning thread alone with relaxed atomics so other threads read them without locks, nothing is allocated
+	   on the recording path */
+	class profile_table
+	{
+		struct slot
+		{
+			std::atomic<const char*> kernel = nullptr;
+			std::atomic<uint64_t> calls = 0, elements = 0, cycles = 0;
+			std::atomic<uint64_t> histogram[profile_buckets] = {};
+		};
+
+		static constexpr size_t capacity = 256;
+		slot slots[capacity];
+
+		static void add(std::atomic<uint64_t>& a, uint64_t v) { a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed); }
+
+	public:
+		/* kernels past the capacity are counted under one name */
+		static constexpr const char* overflow = "(other kernels)";
+
+		void record(const char* kernel, uint64_t elements, uint64_t cycles)
+		{
+			size_t h = (uintptr_t)kernel * 0x9e3779b97f4a7c15ull >> 56;
+			slot* s = nullptr;
+			for(size_t k = 0; k < capacity / 2; k++)
+			{
+				slot& c = slots[(h + k) % capacity];
+				const char* key = c.kernel.load(std::memory_order_relaxed);
+				if(key == kernel)
+				{
+					s = &c;
+					break;
+				}
+				if(key == nullptr)
+				{
+					c.kernel.store(kernel, std::memory_order_release);
+					s = &c;
+					break;
+				}
+			}
+			if(!s)
+				return kernel == overflow ? void() : record(overflow, elements, cycles);
+			add(s->calls, 1);
+			add(s->elements, elements);
+			add(s->cycles, cycles);
+			add(s->histogram[std::min<size_t>(profile_buckets - 1, cycles ? std::bit_width(cycles) - 1 : 0)], 1);
+		}
+
+		/* adds the counters to the entries by kernel name */
+		void collect(std::map<std::string, profile_entry>& into) const
+		{
+			for(const slot& s : slots)
+				if(const char* key = s.kernel.load(std::memory_order_acquire))
+				{
+					profile_entry& e = into[key];
+					e.calls += s.calls.load(std::memory_order_relaxed);
+					e.elements += s.elements.load(std::memory_order_relaxed);
+					e.cycles += s.cycles.load(std::memory_order_relaxed);
+					for(size_t b = 0; b < profile_buckets; b++)
+						e.histogram[b] += s.histogram[b].load(std::memory_order_relaxed);
+				}
+		}
+	};
+
+	/* tables of the live threads, the totals of exited threads and the baseline of the last reset, never destroyed
+	   since thread_pool workers and other threads exiting during static destruction still fold their tables into it */
+	struct profile_registry
+	{
+		std::mutex lock;
+		std::vector<const profile_table*> live;
+		std::map<std::string, profile_entry> retired, baseline;
+
+		static profile_registry& instance()
+		{
+			static profile_registry& r = *new profile_registry;
+			return r;
+		}
+
+		std::map<std::string, profile_entry> totals()
+		{
+			std::map<std::string, profile_entry> t = retired;
+			for(const profile_table* p : live)
+				p->collect(t);
+			return t;
+		}
+	};
+
+	/* table of the calling thread, registered on first use and folded into the retired totals on exit */
+	inline profile_table& profile_thread()
+	{
+		static thread_local struct owner
+		{
+			profile_table* table = new profile_table;
+			owner()
+			{
+				profile_registry& r = profile_registry::instance();
+				std::lock_guard l(r.lock);
+				r.live.push_back(table);
+			}
+			~owner()
+			{
+				profile_registry& r = profile_registry::instance();
+				std::lock_guard l(r.lock);
+				table->collect(r.retired);
+				std::erase(r.live, table);
+				delete table;
+			}
+		} o;
+		return *o.table;
+	}
+
+	/* runs f and records its cycles under kernel, its result as the element count when it is one */
+	template<typename F>
+	inline __attribute__((__always_inline__)) auto profile_call(const char* kernel, F&& f)
+	{
+		const uint64_t t0 = profile_clock();
+		if constexpr(std::is_void_v<decltype(f())>)
+		{
+			f();
+			profile_thread().record(kernel, 0, profile_clock() - t0);
+		}
+		else
+		{
+			auto r = f();
+			const uint64_t t1 = profile_clock();
+			uint64_t elements = 0;
+			if constexpr(std::is_integral_v<decltype(r)>)
+				elements = r;
+			profile_thread().record(kernel, elements, t1 - t0);
+			return r;
+		}
+	}
+#endif
+
+	/* totals per kernel since the last reset, most cycles first, safe to call from any thread at any time such as a
+	   per frame or sampling hook while kernels keep running */
+	inline std::vector<profile_entry> profile_snapshot()
+	{
+		std::vector<profile_entry> v;
+#if defined(IDLIB_PROFILE)
+		profile_registry& r = profile_registry::instance();
+		std::lock_guard l(r.lock);
+		for(auto& [kernel, e] : r.totals())
+		{
+			profile_entry d = e;
+			d.kernel = kernel;
+			if(auto b = r.baseline.find(kernel); b != r.baseline.end())
+			{
+				d.calls -= b->second.calls;
+				d.elements -= b->second.elements;
+				d.cycles -= b->second.cycles;
+				for(size_t k = 0; k < profile_buckets; k++)
+					d.histogram[k] -= b->second.histogram[k];
+			}
+			if(d.calls)
+				v.push_back(d);
+		}
+		std::sort(v.begin(), v.end(), [](const profile_entry& a, const profile_entry& b) { return a.cycles > b.cycles; });
+#endif
+		return v;
+	}
+
+	/* starts the totals over, the counters keep running and the current totals become the baseline */
+	inline void profile_reset()
+	{
+#if defined(IDLIB_PROFILE)
+		profile_registry& r = profile_registry::instance();
+		std::lock_guard l(r.lock);
+		r.baseline = r.totals();
+#endif
+	}
+
+	/* the snapshot as JSON, histograms trimmed after their last non-zero bucket */
+	inline std::string profile_json()
+	{
+		auto escape = [](const std::string& s)
+		{
+			std::string e;
+			for(char c : s)
+			{
+				if(c == '"' || c == '\\')
+					e += '\\';
+				e += c;
+			}
+			return e;
+		};
+		const char* clock =
+#if defined(IDLIB_PROFILE)
+			profile_clock_source();
+#else
+			"none";
+#endif
+		std::string json = std::string("{\n\t\"clock\": \"") + clock + "\",\n\t\"kernels\": [";
+		const std::vector<profile_entry> entries = profile_snapshot();
+		for(size_t i = 0; i < entries.size(); i++)
+		{
+			const profile_entry& e = entries[i];
+			char line[128];
+			snprintf(line, sizeof(line), "\", \"calls\": %llu, \"elements\": %llu, \"cycles\": %llu, \"histogram\": [",
+			         (unsigned long long)e.calls, (unsigned long long)e.elements, (unsigned long long)e.cycles);
+			json += std::string(i ? ",\n" : "\n") + "\t\t{ \"kernel\": \"" + escape(e.kernel) + line;
+			const size_t used = profile_buckets - (std::find_if(e.histogram.rbegin(), e.histogram.rend(), [](uint64_t h) { return h != 0; }) - e.histogram.rbegin());
+			for(size_t b = 0; b < used; b++)
+				json += (b ? ", " : "") + std::to_string(e.histogram[b]);
+			json += "] }";
+		}
+		return json + (entries.empty() ? "]\n}\n" : "\n\t]\n}\n");
+	}
+};
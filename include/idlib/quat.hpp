@@ -0,0 +1,303 @@
+#pragma once
+
+#include <cmath>
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+#include <idlib/transcendental.hpp>
+
+namespace id::math::type
+{
+	/* rotation quaternion x i + y j + z k + w held in one 4-vector { x, y, z, w } */
+	template<sca T>
+	using quat = vec<T,4>;
+
+	using quatf_t = quat<vecf_t>;
+	using quatd_t = quat<vecd_t>;
+
+	/* 4-vector cross product of the xyz lanes, the w lane is zero */
+	template<typename V>
+	inline __attribute__((__always_inline__)) V cross4(V a, V b)
+	{
+		return swizzle4<1,2,0,3>(a) * swizzle4<2,0,1,3>(b) - swizzle4<2,0,1,3>(a) * swizzle4<1,2,0,3>(b);
+	}
+
+	/* horizontal sum of the four lanes of v splat to all lanes */
+	template<typename V>
+	inline __attribute__((__always_inline__)) V dot4_splat(V a, V b)
+	{
+		V p = a * b;
+		p += swizzle4<1,0,3,2>(p);
+		return p + swizzle4<2,3,0,1>(p);
+	}
+
+	/* weights wa, wb of slerp(a, b, t) = wa a + wb b for cos(angle) = x in [0, 1], i.e. sin((1 - t) angle) / sin(angle)
+	   and sin(t angle) / sin(angle). float lanes evaluate Eberly's series in x - 1 with eight terms and a corrected tail,
+	   no trigonometric call or division and within 3e-5 of the exact result. double lanes take sin(angle) as
+	   sqrt(1 - x^2), the angle from atan2_lanes and both sines from one sincos_lanes, within 6e-16, and a double
+	   scalar the exact form. V is a scalar or a vector of per lane arguments */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::pair<V,V> slerp_weights(V x, V t)
+	{
+		using E = decltype([] { if constexpr(sca<V>) return V{}; else return V{}[0]; }());
+		if constexpr(std::is_same_v<E, f32<1>>)
+		{
+			static constexpr E mu   = 1.85298109240830f;
+			static constexpr E u[8] = { 1.f / (1 * 3), 1.f / (2 * 5), 1.f / (3 * 7), 1.f / (4 * 9), 1.f / (5 * 11), 1.f / (6 * 13), 1.f / (7 * 15), mu / (8 * 17) };
+			static constexpr E v[8] = { 1.f / 3, 2.f / 5, 3.f / 7, 4.f / 9, 5.f / 11, 6.f / 13, 7.f / 15, mu * 8 / 17 };
+			V xm1 = x - 1, s = 1 - t, tt = t * t, ss = s * s;
+			V ca = V{} + 1, cb = V{} + 1;
+#pragma GCC unroll 8
+			for(int i = 7; i >= 0; i--)
+			{
+				ca = 1 + (u[i] * ss - v[i]) * xm1 * ca;
+				cb = 1 + (u[i] * tt - v[i]) * xm1 * cb;
+			}
+			return { s * ca, t * cb };
+		}
+		else if constexpr(sca<V>)
+		{
+			E a = std::acos(std::min<E>(x, 1)), s = std::sin(a);
+			if(s < std::numeric_limits<E>::epsilon())
+				return { 1 - t, t };
+			return { std::sin((1 - t) * a) / s, std::sin(t * a) / s };
+		}
+		else
+		{
+			static constexpr size_t N = sizeof(V) / sizeof(E);
+			/* compares of vectors wider than the registers of the tier scalarize, halves keep them in registers */
+			if constexpr(sizeof(V) > simd_native_bytes)
+				if(!simd_has(sizeof(V) == 64 ? simd_tier::avx512 : simd_tier::avx2))
+					return [&]<size_t... I>(std::index_sequence<I...>)
+					{
+						auto [la, lb] = slerp_weights(__builtin_shufflevector(x, x, I...), __builtin_shufflevector(t, t, I...));
+						auto [ha, hb] = slerp_weights(__builtin_shufflevector(x, x, (I + N / 2)...), __builtin_shufflevector(t, t, (I + N / 2)...));
+						return std::pair<V,V>{ __builtin_shufflevector(la, ha, I..., (I + N / 2)...), __builtin_shufflevector(lb, hb, I..., (I + N / 2)...) };
+					}(std::make_index_sequence<N / 2>{});
+			x = x < 1 ? x : 1;
+			const V s = sqrt_lanes((1 - x) * (1 + x)), a = atan2_lanes(s, x);
+			/* sin((1 - t) angle) = s cos(t angle) - x sin(t angle) shares one reduction, nearly parallel lanes where
+			   1 / s blows up interpolate linearly like the scalar form */
+			const auto [st, ct] = sincos_lanes(t * a);
+			const V wb = st / s;
+			const auto near = s < std::numeric_limits<E>::epsilon();
+			return { near ? 1 - t : ct - x * wb, near ? t : wb };
+		}
+	}
+
+	/* hamilton product a * b, the rotation b followed by a */
+	template<sca T>
+	inline quat<T> mul_quat(quat<T> a, quat<T> b)
+	{
+		static constexpr quat<T> s0 = { 1, -1, 1, -1 }, s1 = { 1, 1, -1, -1 }, s2 = { -1, 1, 1, -1 };
+		return swizzle4<3,3,3,3>(a) * b
+		     + swizzle4<0,0,0,0>(a) * swizzle4<3,2,1,0>(b) * s0
+		     + swizzle4<1,1,1,1>(a) * swizzle4<2,3,0,1>(b) * s1
+		     + swizzle4<2,2,2,2>(a) * swizzle4<1,0,3,2>(b) * s2;
+	}
+
+	/* conjugate, the inverse rotation of a unit quaternion */
+	template<sca T>
+	inline quat<T> conjugate(quat<T> q)
+	{
+		static constexpr quat<T> s = { -1, -1, -1, 1 };
+		return q * s;
+	}
+
+	/* v rotated by the unit quaternion q, v + w t + q x t with t = 2 q x v */
+	template<sca T>
+	inline vec<T,3> rotate(quat<T> q, const vec<T,3>& v)
+	{
+		vec<T,4> p = { v[0], v[1], v[2], 0 };
+		vec<T,4> t = cross4(q, p);
+		t += t;
+		vec<T,4> r = p + swizzle4<3,3,3,3>(q) * t + cross4(q, t);
+		return { r[0], r[1], r[2] };
+	}
+
+	/* normalized linear interpolation along the shorter arc */
+	template<sca T>
+	inline quat<T> nlerp(quat<T> a, quat<T> b, T t)
+	{
+		quat<T> d = dot4_splat(a, b);
+		quat<T> r = a + ((d < 0 ? -b : b) - a) * t;
+		return r / sqrt_lanes(dot4_splat(r, r));
+	}
+
+	/* spherical linear interpolation along the shorter arc */
+	template<sca T>
+	inline quat<T> slerp(quat<T> a, quat<T> b, T t)
+	{
+		T d = dot4_splat(a, b)[0];
+		auto [wa, wb] = slerp_weights(d < 0 ? -d : d, t);
+		return a * wa + b * (d < 0 ? -wb : wb);
+	}
+
+	/* packet hamilton product a * b */
+	template<typename V>
+	inline std::array<V,4> mul_quat(const std::array<V,4>& a, const std::array<V,4>& b)
+	{
+		return { a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+		         a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+		         a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+		         a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2] };
+	}
+
+	/* packet conjugate */
+	template<typename V>
+	inline std::array<V,4> conjugate(const std::array<V,4>& q) { return { -q[0], -q[1], -q[2], q[3] }; }
+
+	/* packet rotation of v by the unit quaternions q */
+	template<typename V>
+	inline std::array<V,3> rotate(const std::array<V,4>& q, const std::array<V,3>& v)
+	{
+		std::array<V,3> u = { q[0], q[1], q[2] };
+		std::array<V,3> t = cross(u, v);
+		for(size_t c = 0; c < 3; c++)
+			t[c] += t[c];
+		std::array<V,3> s = cross(u, t);
+		return { v[0] + q[3] * t[0] + s[0], v[1] + q[3] * t[1] + s[1], v[2] + q[3] * t[2] + s[2] };
+	}
+
+	/* packet nlerp with a per lane t */
+	template<typename V>
+	inline std::array<V,4> nlerp(const std::array<V,4>& a, const std::array<V,4>& b, V t)
+	{
+		V f = dot(a, b) < 0 ? -t : t, g = 1 - t;
+		std::array<V,4> r;
+		for(size_t c = 0; c < 4; c++)
+			r[c] = a[c] * g + b[c] * f;
+		return normalize(r);
+	}
+
+	/* packet slerp with a per lane t */
+	template<typename V>
+	inline std::array<V,4> slerp(const std::array<V,4>& a, const std::array<V,4>& b, V t)
+	{
+		V d = dot(a, b);
+		auto [wa, wb] = slerp_weights(d < 0 ? -d : d, t);
+		wb = d < 0 ? -wb : wb;
+		std::array<V,4> r;
+		for(size_t c = 0; c < 4; c++)
+			r[c] = a[c] * wa + b[c] * wb;
+		return r;
+	}
+
+	/* packet rotation matrices of the unit quaternions q, m[col][row] */
+	template<typename V>
+	inline std::array<std::array<V,4>,4> to_mat(const std::array<V,4>& q)
+	{
+		V x2 = q[0] + q[0], y2 = q[1] + q[1], z2 = q[2] + q[2];
+		V xx = q[0] * x2, yy = q[1] * y2, zz = q[2] * z2;
+		V xy = q[0] * y2, xz = q[0] * z2, yz = q[1] * z2;
+		V wx = q[3] * x2, wy = q[3] * y2, wz = q[3] * z2;
+		V zero = {}, one = zero + 1;
+		return {{ { one - yy - zz, xy + wz, xz - wy, zero },
+		          { xy - wz, one - xx - zz, yz + wx, zero },
+		          { xz + wy, yz - wx, one - xx - yy, zero },
+		          { zero, zero, zero, one } }};
+	}
+
+	/* rotation matrix of the unit quaternion q */
+	template<sca T>
+	inline void to_mat(quat<T> q, mat<T,4,4>& dst)
+	{
+		auto m = to_mat(std::array<T,4>{ q[0], q[1], q[2], q[3] });
+		for(size_t c = 0; c < 4; c++)
+			dst[c] = (vec<T,4>){ m[c][0], m[c][1], m[c][2], m[c][3] };
+	}
+
+	/* unit quaternion of the rotation part of m, branching on the largest diagonal term for precision */
+	template<sca T>
+	inline quat<T> to_quat(const mat<T,4,4>& m)
+	{
+		/* m[c][r] is row r column c */
+		T tr = m[0][0] + m[1][1] + m[2][2];
+		if(tr > 0)
+		{
+			T s = std::sqrt(tr + 1) * 2;
+			return quat<T>{ m[1][2] - m[2][1], m[2][0] - m[0][2], m[0][1] - m[1][0], s * s / 4 } / s;
+		}
+		if(m[0][0] > m[1][1] && m[0][0] > m[2][2])
+		{
+			T s = std::sqrt(1 + m[0][0] - m[1][1] - m[2][2]) * 2;
+			return quat<T>{ s * s / 4, m[1][0] + m[0][1], m[2][0] + m[0][2], m[1][2] - m[2][1] } / s;
+		}
+		if(m[1][1] > m[2][2])
+		{
+			T s = std::sqrt(1 + m[1][1] - m[0][0] - m[2][2]) * 2;
+			return quat<T>{ m[1][0] + m[0][1], s * s / 4, m[2][1] + m[1][2], m[2][0] - m[0][2] } / s;
+		}
+		T s = std::sqrt(1 + m[2][2] - m[0][0] - m[1][1]) * 2;
+		return quat<T>{ m[2][0] + m[0][2], m[2][1] + m[1][2], s * s / 4, m[0][1] - m[1][0] } / s;
+	}
+
+	/* dst = nlerp(a, b, t) over every joint of equally sized soa or aosoa quaternion containers */
+	template<typename C, sca T>
+	inline void nlerp(C& dst, const C& a, const C& b, T t)
+	{
+		using V = typename C::packet_type::value_type;
+		apply([t](const auto& p, const auto& q) { return nlerp(p, q, V{} + t); }, dst, a, b);
+	}
+
+	/* dst = slerp(a, b, t) over every joint of equally sized soa or aosoa quaternion containers,
+	   per joint weights go through apply with the packet form, e.g. apply([](auto a, auto b, auto t) { return slerp(a, b, t[0]); }, d, a, b, t) */
+	template<typename C, sca T>
+	inline void slerp(C& dst, const C& a, const C& b, T t)
+	{
+		using V = typename C::packet_type::value_type;
+		apply([t](const auto& p, const auto& q) { return slerp(p, q, V{} + t); }, dst, a, b);
+	}
+
+	/* rotation matrices of the joints of a soa or aosoa quaternion container, translated by the joints of an equally
+	   sized 3-component container when one is given, 4-lane transposes back to column vectors, returns the number of
+	   matrices written */
+	template<typename C, typename P = C>
+	size_t to_mat(const C& q, std::span<typename C::value_type[4]> dst, const P* pos = nullptr)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			using T = std::remove_cvref_t<decltype(V{}[0])>;
+			static constexpr size_t W = sizeof(V) / sizeof(T), G = W / 4;
+			static_assert(W % 4 == 0, "whole 4-lane groups");
+			const size_t len = std::min(q.size(), dst.size());
+
+			for(size_t k = 0; k * W < len; k++)
+			{
+				auto m = to_mat(q.load(k));
+				if(pos)
+				{
+					auto p = pos->load(k);
+					m[3] = { p[0], p[1], p[2], m[3][3] };
+				}
+				const size_t n = std::min(W, len - k * W);
+				for(size_t c = 0; c < 4; c++)
+				{
+					if(c == 3 && !pos)
+					{
+						for(size_t j = 0; j < n; j++)
+							storeu(&dst[k * W + j][3], (vec<T,4>){ 0, 0, 0, 1 });
+						break;
+					}
+					std::array<vec<T,4>,4> r[G];
+					for(size_t row = 0; row < 4; row++)
+						split4<G>(m[c][row], [&](size_t g, vec<T,4> v) { r[g][row] = v; });
+					for(size_t g = 0; g < G; g++)
+					{
+						transpose4(r[g][0], r[g][1], r[g][2], r[g][3]);
+						for(size_t j = 0; j < 4; j++)
+							if(n == W || 4 * g + j < n)
+								storeu(&dst[k * W + 4 * g + j][c], r[g][j]);
+					}
+				}
+			}
+			return len;
+		});
+	}
+
+	/* translated form of to_mat, the translations of pos fill the last column */
+	template<typename C, typename P>
+	size_t to_mat(const C& q, const P& pos, std::span<typename C::value_type[4]> dst) { return to_mat(q, dst, &pos); }
+};
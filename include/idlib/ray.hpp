@@ -0,0 +1,138 @@
+#pragma once
+
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+
+namespace id::math::type
+{
+	/* per lane hit mask and ray parameter of the hit, t is unspecified in missed lanes */
+	template<typename V>
+	struct hits
+	{
+		lane_mask<V> hit;
+		V t;
+	};
+
+	/* lane parallel Möller-Trumbore test of the rays o + t d against the triangles v0 v1 v2 for t in (0, tmax),
+	   both sides are packets so W rays meet one broadcast triangle or one broadcast ray meets W triangles.
+	   parallel and degenerate lanes divide by a zero determinant and fail every comparison */
+	template<typename V>
+	inline hits<V> ray_triangle(const std::array<V,3>& o, const std::array<V,3>& d,
+	                            const std::array<V,3>& v0, const std::array<V,3>& v1, const std::array<V,3>& v2, V tmax)
+	{
+		std::array<V,3> e1, e2, s;
+		for(size_t c = 0; c < 3; c++)
+		{
+			e1[c] = v1[c] - v0[c];
+			e2[c] = v2[c] - v0[c];
+			s[c]  = o[c] - v0[c];
+		}
+		std::array<V,3> p = cross(d, e2), q = cross(s, e1);
+		V r = 1 / dot(e1, p);
+		V u = dot(s, p) * r, v = dot(d, q) * r, t = dot(e2, q) * r;
+		return { (u >= 0) & (v >= 0) & (u + v <= 1) & (t > 0) & (t < tmax), t };
+	}
+
+	/* W rays against one triangle */
+	template<sca T, size_t W>
+	inline hits<vector_aligned<T,W>> ray_triangle(const packet<T,3,W>& o, const packet<T,3,W>& d,
+	                                              const vec<T,3>& v0, const vec<T,3>& v1, const vec<T,3>& v2, vector_aligned<T,W> tmax)
+	{
+		return ray_triangle(o, d, broadcast<T,3,W>(v0), broadcast<T,3,W>(v1), broadcast<T,3,W>(v2), tmax);
+	}
+
+	/* one ray against W triangles */
+	template<sca T, size_t W>
+	inline hits<vector_aligned<T,W>> ray_triangle(const vec<T,3>& o, const vec<T,3>& d,
+	                                              const packet<T,3,W>& v0, const packet<T,3,W>& v1, const packet<T,3,W>& v2, vector_aligned<T,W> tmax)
+	{
+		return ray_triangle(broadcast<T,3,W>(o), broadcast<T,3,W>(d), v0, v1, v2, tmax);
+	}
+
+	/* lane parallel slab test of the rays o + t d against the boxes [lo, hi] for t in [0, tmax], inv is the per
+	   component reciprocal of the direction, t is the entry parameter clamped to 0 for rays starting inside.
+	   axis parallel rays lying exactly in a slab plane get a NaN bound and consistently miss */
+	template<typename V>
+	inline hits<V> ray_box(const std::array<V,3>& o, const std::array<V,3>& inv, const std::array<V,3>& lo, const std::array<V,3>& hi, V tmax)
+	{
+		V tn = {}, tf = tmax;
+		for(size_t c = 0; c < 3; c++)
+		{
+			V a = (lo[c] - o[c]) * inv[c], b = (hi[c] - o[c]) * inv[c];
+			V n = a < b ? a : b, f = a < b ? b : a;
+			tn = n > tn ? n : tn;
+			tf = f < tf ? f : tf;
+		}
+		return { tn <= tf, tn };
+	}
+
+	/* W rays against one box */
+	template<sca T, size_t W>
+	inline hits<vector_aligned<T,W>> ray_box(const packet<T,3,W>& o, const packet<T,3,W>& inv,
+	                                         const vec<T,3>& lo, const vec<T,3>& hi, vector_aligned<T,W> tmax)
+	{
+		return ray_box(o, inv, broadcast<T,3,W>(lo), broadcast<T,3,W>(hi), tmax);
+	}
+
+	/* one ray against W boxes */
+	template<sca T, size_t W>
+	inline hits<vector_aligned<T,W>> ray_box(const vec<T,3>& o, const vec<T,3>& inv,
+	                                         const packet<T,3,W>& lo, const packet<T,3,W>& hi, vector_aligned<T,W> tmax)
+	{
+		return ray_box(broadcast<T,3,W>(o), broadcast<T,3,W>(inv), lo, hi, tmax);
+	}
+
+	/* nearest of the triangles held in equally sized soa or aosoa vertex containers hit by the ray o + t d for
+	   t in (0, tmax), one packet of triangles per step with a per lane running nearest t, returns the triangle
+	   index and t, or v0.size() and tmax on a miss */
+	template<typename C, sca T>
+	std::pair<size_t, T> raycast(const vec<T,3>& o, const vec<T,3>& d, const C& v0, const C& v1, const C& v2, T tmax)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			using I = lane_mask<V>;
+			using E = std::remove_cvref_t<decltype(I{}[0])>;
+			static constexpr size_t W = sizeof(V) / sizeof(T);
+			const auto po = broadcast<T,3,W>(o), pd = broadcast<T,3,W>(d);
+			V best = (V){} + tmax;
+			I idx = (I){} - 1, lane = []<size_t... L>(std::index_sequence<L...>) { return I{ (E)L... }; }(std::make_index_sequence<W>{});
+
+			/* lanes past size() hold degenerate zero triangles and never hit */
+			for(size_t k = 0; k < v0.packets(); k++)
+			{
+				hits<V> h = ray_triangle(po, pd, v0.load(k), v1.load(k), v2.load(k), best);
+				best = h.hit ? h.t : best;
+				idx  = h.hit ? lane + (E)(k * W) : idx;
+			}
+
+			std::pair<size_t, T> r = { v0.size(), tmax };
+			for(size_t l = 0; l < W; l++)
+				if(idx[l] >= 0 && (best[l] < r.second || (best[l] == r.second && (size_t)idx[l] < r.first)))
+					r = { (size_t)idx[l], best[l] };
+			return r;
+		});
+	}
+
+	/* any hit form of raycast for line of sight queries, stops at the first packet with a hit */
+	template<typename C, sca T>
+	bool occluded(const vec<T,3>& o, const vec<T,3>& d, const C& v0, const C& v1, const C& v2, T tmax)
+	{
+		return simd_dispatch([&]
+		{
+			using V = typename C::packet_type::value_type;
+			static constexpr size_t W = sizeof(V) / sizeof(T);
+			const auto po = broadcast<T,3,W>(o), pd = broadcast<T,3,W>(d);
+			const V t = (V){} + tmax;
+
+			for(size_t k = 0; k < v0.packets(); k++)
+			{
+				if(stdx::any_of(to_simd(ray_triangle(po, pd, v0.load(k), v1.load(k), v2.load(k), t).hit) != 0))
+					return true;
+			}
+			return false;
+		});
+	}
+};
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <span>
+
+#include <idlib/math.hpp>
+
+namespace id::math::type
+{
+	/* default AoSoA block size, the native SIMD width or that of a REG byte register rounded up to whole 4-lane groups */
+	template<sca T, size_t REG = sizeof(T) * lanes<T>>
+	static constexpr size_t block = std::max<size_t>(4, lanes<T,REG>);
+
+	/* W elements of an N-component vector, one W-wide register per component */
+	template<sca T, size_t N, size_t W = block<T>>
+	using packet = std::array<vector_aligned<T,W>, N>;
+
+	/* square roots of the AVX and AVX-512 registers, built for their tier and taking the vector by reference so the
+	   clones of that tier inline them and no wide vector is passed in the baseline's ABI */
+	inline __attribute__((__target__("avx"))) void sqrt_wide(vector_aligned<f32<1>,8>& v) { v = (vector_aligned<f32<1>,8>)_mm256_sqrt_ps((__m256)v); }
+	inline __attribute__((__target__("avx"))) void sqrt_wide(vector_aligned<f64<1>,4>& v) { v = (vector_aligned<f64<1>,4>)_mm256_sqrt_pd((__m256d)v); }
+	inline __attribute__((__target__("avx512f"))) void sqrt_wide(vector_aligned<f32<1>,16>& v)
+	{
+		v = (vector_aligned<f32<1>,16>)_mm512_mask_sqrt_ps((__m512)v, (__mmask16)-1, (__m512)v);
+	}
+	inline __attribute__((__target__("avx512f"))) void sqrt_wide(vector_aligned<f64<1>,8>& v)
+	{
+		v = (vector_aligned<f64<1>,8>)_mm512_mask_sqrt_pd((__m512d)v, (__mmask8)-1, (__m512d)v);
+	}
+
+	/* lane wise square root through stdx::sqrt, vectors wider than the native register take sqrt_wide where their
+	   tier runs and are halved in registers otherwise since the fixed_size ABI round trips through memory, 64-byte
+	   AVX-512 vectors use the masked form to avoid GCC 12 reading _mm512_undefined */
+	template<typename V>
+	inline __attribute__((__always_inline__)) V sqrt_lanes(V v)
+	{
+		using T = std::remove_cvref_t<decltype(v[0])>;
+		static constexpr size_t N = sizeof(V) / sizeof(T);
+		if constexpr(sizeof(V) > simd_native_bytes && requires { sqrt_wide(v); })
+			if(simd_has(sizeof(V) == 64 ? simd_tier::avx512 : simd_tier::avx2))
+			{
+				sqrt_wide(v);
+				return v;
+			}
+#if defined(__AVX512F__)
+		if constexpr(sizeof(V) == 64 && std::is_same_v<T, f32<1>>)
+			return (V)_mm512_mask_sqrt_ps((__m512)v, (__mmask16)-1, (__m512)v);
+		if constexpr(sizeof(V) == 64 && std::is_same_v<T, f64<1>>)
+			return (V)_mm512_mask_sqrt_pd((__m512d)v, (__mmask8)-1, (__m512d)v);
+#endif
+		if constexpr(N > lanes<T>)
+			return [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				vector_aligned<T,N / 2> lo = sqrt_lanes(__builtin_shufflevector(v, v, I...));
+				vector_aligned<T,N / 2> hi = sqrt_lanes(__builtin_shufflevector(v, v, (I + N / 2)...));
+				return __builtin_shufflevector(lo, hi, I..., (I + N / 2)...);
+			}(std::make_index_sequence<N / 2>{});
+		else
+			return to_vector(stdx::sqrt(to_simd(v)));
+	}
+
+	/* packet dot product */
+	template<typename V, size_t N>
+	inline V dot(const std::array<V,N>& a, const std::array<V,N>& b)
+	{
+		V r = a[0] * b[0];
+		for(size_t c = 1; c < N; c++)
+			r += a[c] * b[c];
+		return r;
+	}
+
+	/* packet cross product */
+	template<typename V>
+	inline std::array<V,3> cross(const std::array<V,3>& a, const std::array<V,3>& b)
+	{
+		return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+	}
+
+	/* packet scalar triple product a . (b x c), the 3x3 determinant of the rows a, b, c */
+	template<typename V>
+	inline V det(const std::array<V,3>& a, const std::array<V,3>& b, const std::array<V,3>& c) { return dot(a, cross(b, c)); }
+
+	/* packet euclidean length */
+	template<typename V, size_t N>
+	inline V length(const std::array<V,N>& a) { return sqrt_lanes(dot(a, a)); }
+
+	/* packet normalization, zero length lanes stay zero */
+	template<typename V, size_t N>
+	inline std::array<V,N> normalize(const std::array<V,N>& a)
+	{
+		V l = length(a);
+		V r = l > 0 ? 1 / l : 0;
+		std::array<V,N> d;
+		for(size_t c = 0; c < N; c++)
+			d[c] = a[c] * r;
+		return d;
+	}
+
+	/* packet linear interpolation a + (b - a) * t with a per lane t */
+	template<typename V, size_t N>
+	inline std::array<V,N> lerp(const std::array<V,N>& a, const std::array<V,N>& b, V t)
+	{
+		std::array<V,N> d;
+		for(size_t c = 0; c < N; c++)
+			d[c] = a[c] + (b[c] - a[c]) * t;
+		return d;
+	}
+
+	/* packet component wise minimum */
+	template<typename V, size_t N>
+	inline std::array<V,N> min(const std::array<V,N>& a, const std::array<V,N>& b)
+	{
+		std::array<V,N> d;
+		for(size_t c = 0; c < N; c++)
+			d[c] = a[c] < b[c] ? a[c] : b[c];
+		return d;
+	}
+
+	/* packet component wise maximum */
+	template<typename V, size_t N>
+	inline std::array<V,N> max(const std::array<V,N>& a, const std::array<V,N>& b)
+	{
+		std::array<V,N> d;
+		for(size_t c = 0; c < N; c++)
+			d[c] = a[c] > b[c] ? a[c] : b[c];
+		return d;
+	}
+
+	/* packet component wise fused multiply-add a * b + c */
+	template<typename V, size_t N>
+	inline std::array<V,N> fma(const std::array<V,N>& a, const std::array<V,N>& b, const std::array<V,N>& c)
+	{
+		std::array<V,N> d;
+		for(size_t k = 0; k < N; k++)
+			d[k] = a[k] * b[k] + c[k];
+		return d;
+	}
+
+	/* packet of W copies of the N-vector v */
+	template<sca T, size_t N, size_t W = block<T>>
+	inline packet<T,N,W> broadcast(const vec<T,N>& v)
+	{
+		packet<T,N,W> p;
+		for(size_t c = 0; c < N; c++)
+			p[c] = (vector_aligned<T,W>){} + v[c];
+		return p;
+	}
+
+	/* four AoS N-vectors at src as N component 4-vectors, in-register transpose */
+	template<sca T, size_t N>
+	inline __attribute__((__always_inline__)) std::array<vector_aligned<T,4>,N> aos_to_soa4(const T* src)
+	{
+		using V = vector_aligned<T,4>;
+		static_assert(N >= 1 && N <= 4, "1 to 4 components");
+		std::array<vector_aligned<T,4>,N> d;
+		if constexpr(N == 1)
+			__builtin_memcpy(&d[0], src, sizeof(V));
+		if constexpr(N == 2)
+		{
+			V a, b;
+			__builtin_memcpy(&a, src, sizeof(a));
+			__builtin_memcpy(&b, src + 4, sizeof(b));
+			d[0] = __builtin_shufflevector(a, b, 0, 2, 4, 6);
+			d[1] = __builtin_shufflevector(a, b, 1, 3, 5, 7);
+		}
+		if constexpr(N == 3)
+			deinterleave3<T>(src, d[0], d[1], d[2]);
+		if constexpr(N == 4)
+		{
+			V r0, r1, r2, r3;
+			__builtin_memcpy(&r0, src, sizeof(r0));
+			__builtin_memcpy(&r1, src + 4, sizeof(r1));
+			__builtin_memcpy(&r2, src + 8, sizeof(r2));
+			__builtin_memcpy(&r3, src + 12, sizeof(r3));
+			transpose4(r0, r1, r2, r3);
+			d = { r0, r1, r2, r3 };
+		}
+		return d;
+	}
+
+	/* N component 4-vectors back to four AoS N-vectors at dst */
+	template<sca T, size_t N>
+	inline __attribute__((__always_inline__)) void soa4_to_aos(const std::array<vector_aligned<T,4>,N>& src, T* dst)
+	{
+		using V = vector_aligned<T,4>;
+		static_assert(N >= 1 && N <= 4, "1 to 4 components");
+		if constexpr(N == 1)
+			__builtin_memcpy(dst, &src[0], sizeof(V));
+		if constexpr(N == 2)
+		{
+			V a = __builtin_shufflevector(src[0], src[1], 0, 4, 1, 5);
+			V b = __builtin_shufflevector(src[0], src[1], 2, 6, 3, 7);
+			__builtin_memcpy(dst, &a, sizeof(a));
+			__builtin_memcpy(dst + 4, &b, sizeof(b));
+		}
+		if constexpr(N == 3)
+			interleave3<T>(dst, src[0], src[1], src[2]);
+		if constexpr(N == 4)
+		{
+			V r0 = src[0], r1 = src[1], r2 = src[2], r3 = src[3];
+			transpose4(r0, r1, r2, r3);
+			__builtin_memcpy(dst, &r0, sizeof(r0));
+			__builtin_memcpy(dst + 4, &r1, sizeof(r1));
+			__builtin_memcpy(dst + 8, &r2, sizeof(r2));
+			__builtin_memcpy(dst + 12, &r3, sizeof(r3));
+		}
+	}
+
+	/* W consecutive AoS N-vectors as a packet, 4-lane transposes joined to full width */
+	template<sca T, size_t N, size_t W = block<T>>
+	inline __attribute__((__always_inline__)) packet<T,N,W> gather(const vec<T,N>* src)
+	{
+		static_assert(W % 4 == 0, "whole 4-lane groups");
+		static constexpr size_t G = W / 4;
+		std::array<std::array<vector_aligned<T,4>,N>,G> q;
+#pragma GCC unroll 16
+		for(size_t g = 0; g < G; g++)
+			q[g] = aos_to_soa4<T,N>(&src[4 * g][0]);
+		packet<T,N,W> p;
+#pragma GCC unroll 4
+		for(size_t c = 0; c < N; c++)
+			p[c] = join4<G>([&](size_t g) { return q[g][c]; });
+		return p;
+	}
+
+	/* packet split into W consecutive AoS N-vectors */
+	template<sca T, size_t N, size_t W = block<T>>
+	inline __attribute__((__always_inline__)) void scatter(const packet<T,N,W>& p, vec<T,N>* dst)
+	{
+		static_assert(W % 4 == 0, "whole 4-lane groups");
+		static constexpr size_t G = W / 4;
+		std::array<std::array<vector_aligned<T,4>,N>,G> q;
+#pragma GCC unroll 4
+		for(size_t c = 0; c < N; c++)
+			split4<G>(p[c], [&](size_t g, vector_aligned<T,4> v) { q[g][c] = v; });
+#pragma GCC unroll 16
+		for(size_t g = 0; g < G; g++)
+			soa4_to_aos<T,N>(q[g], &dst[4 * g][0]);
+	}
+
+	/* blocked AoSoA storage of N-vectors, W elements per block with one register per component,
+	   lanes past size() are zero */
+	template<sca T, size_t N, size_t W = block<T>>
+	class aosoa
+	{
+	public:
+		using value_type  = vec<T,N>;
+		using packet_type = packet<T,N,W>;
+
+		aosoa(size_t n = 0) : len(n), blocks((n + W - 1) / W) {}
+		aosoa(std::span<const value_type> src) : aosoa(src.size()) { assign(src); }
+
+		size_t size() const    { return len; }
+		size_t packets() const { return blocks.size(); }
+
+		packet_type load(size_t k) const
+		{
+			packet_type p;
+			for(size_t c = 0; c < N; c++)
+				p[c] = loadu<vector_aligned<T,W>>(&blocks[k][c]);
+			return p;
+		}
+		void store(size_t k, const packet_type& p)
+		{
+			for(size_t c = 0; c < N; c++)
+				storeu(&blocks[k][c], p[c]);
+		}
+		packet_type& operator[](size_t k)              { return blocks[k]; }
+		const packet_type& operator[](size_t k) const  { return blocks[k]; }
+
+		value_type get(size_t i) const
+		{
+			value_type v;
+			for(size_t c = 0; c < N; c++)
+				v[c] = blocks[i / W][c][i % W];
+			return v;
+		}
+		void set(size_t i, const value_type& v)
+		{
+			for(size_t c = 0; c < N; c++)
+				blocks[i / W][c][i % W] = v[c];
+		}
+
+		/* AoS to AoSoA, src must hold size() elements */
+		void assign(std::span<const value_type> src)
+		{
+			simd_dispatch([&]
+			{
+				size_t k = 0;
+				for(; k < len / W; k++)
+					store(k, gather<T,N,W>(&src[k * W]));
+				if(k * W < len)
+				{
+					value_type in[W] = {};
+					std::copy_n(&src[k * W], len - k * W, in);
+					store(k, gather<T,N,W>(in));
+				}
+			});
+		}
+
+		/* AoSoA to AoS, dst must hold size() elements */
+		void copy(std::span<value_type> dst) const
+		{
+			simd_dispatch([&]
+			{
+				size_t k = 0;
+				for(; k < len / W; k++)
+					scatter<T,N,W>(load(k), &dst[k * W]);
+				if(k * W < len)
+				{
+					value_type out[W];
+					scatter<T,N,W>(load(k), out);
+					std::copy_n(out, len - k * W, &dst[k * W]);
+				}
+			});
+		}
+
+	private:
+		size_t len;
+		std::vector<packet_type> blocks;
+	};
+
+	/* SoA storage of N-vectors, one contiguous array per component padded to whole W-lane packets,
+	   lanes past size() are zero */
+	template<sca T, size_t N, size_t W = block<T>>
+	class soa
+	{
+	public:
+		using value_type  = vec<T,N>;
+		using packet_type = packet<T,N,W>;
+
+		soa(size_t n = 0) : len(n) { for(auto& p : planes) p.resize((n + W - 1) / W); }
+		soa(std::span<const value_type> src) : soa(src.size()) { assign(src); }
+
+		size_t size() const    { return len; }
+		size_t packets() const { return planes[0].size(); }
+
+		packet_type load(size_t k) const
+		{
+			packet_type p;
+			for(size_t c = 0; c < N; c++)
+				p[c] = loadu<vector_aligned<T,W>>(&planes[c][k]);
+			return p;
+		}
+		void store(size_t k, const packet_type& p)
+		{
+			for(size_t c = 0; c < N; c++)
+				storeu(&planes[c][k], p[c]);
+		}
+
+		/* scalar view of component c */
+		std::span<T> component(size_t c)             { return { &planes[c][0][0], len }; }
+		std::span<const T> component(size_t c) const { return { &planes[c][0][0], len }; }
+
+		value_type get(size_t i) const
+		{
+			value_type v;
+			for(size_t c = 0; c < N; c++)
+				v[c] = planes[c][i / W][i % W];
+			return v;
+		}
+		void set(size_t i, const value_type& v)
+		{
+			for(size_t c = 0; c < N; c++)
+				planes[c][i / W][i % W] = v[c];
+		}
+
+		/* AoS to SoA, src must hold size() elements */
+		void assign(std::span<const value_type> src)
+		{
+			simd_dispatch([&]
+			{
+				size_t k = 0;
+				for(; k < len / W; k++)
+					store(k, gather<T,N,W>(&src[k * W]));
+				if(k * W < len)
+				{
+					value_type in[W] = {};
+					std::copy_n(&src[k * W], len - k * W, in);
+					store(k, gather<T,N,W>(in));
+				}
+			});
+		}
+
+		/* SoA to AoS, dst must hold size() elements */
+		void copy(std::span<value_type> dst) const
+		{
+			simd_dispatch([&]
+			{
+				size_t k = 0;
+				for(; k < len / W; k++)
+					scatter<T,N,W>(load(k), &dst[k * W]);
+				if(k * W < len)
+				{
+					value_type out[W];
+					scatter<T,N,W>(load(k), out);
+					std::copy_n(out, len - k * W, &dst[k * W]);
+				}
+			});
+		}
+
+	private:
+		size_t len;
+		std::array<std::vector<vector_aligned<T,W>>, N> planes;
+	};
+
+	/* dst packet k = f(src packet k...) over all packets of equally sized soa or aosoa containers,
+	   a single register result fills a one component dst, e.g. apply([](auto a, auto b) { return dot(a, b); }, d, a, b) */
+	template<typename F, typename D, typename... S>
+	inline void apply(F&& f, D& dst, const S&... src)
+	{
+		simd_dispatch([&]
+		{
+			for(size_t k = 0; k < dst.packets(); k++)
+			{
+				auto r = f(src.load(k)...);
+				if constexpr(std::is_same_v<decltype(r), typename D::packet_type>)
+					dst.store(k, r);
+				else
+					dst.store(k, { r });
+			}
+		});
+	}
+};
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <cmath>
+#include <numbers>
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+
+namespace id::math::type
+{
+	/* accuracy tier of the lane functions, accurate stays within a few ulp of the element type and fast within 3e-6
+	   relative error in both precisions with shorter polynomials, the error of each function is listed at it */
+	enum class precision { fast, accurate };
+
+	/* builtin vector of float or double lanes, vec<T,N> for power of two N, pvec<T,N> and f32<N> / f64<N> for N > 1 */
+	template<typename V>
+	concept float_lanes = std::floating_point<typename lane_traits<V>::type>
+	                   && std::is_same_v<V, vector_aligned<typename lane_traits<V>::type, lane_traits<V>::size>>;
+
+	/* c[0] x^(N-1) + ... + c[N-1] */
+	template<typename V, typename E, size_t N>
+	inline __attribute__((__always_inline__)) V horner(V x, const E (&c)[N])
+	{
+		V r = (V){} + c[0];
+		for(size_t i = 1; i < N; i++)
+			r = r * x + c[i];
+		return r;
+	}
+
+	/* 1.5 2^mantissa, adding it rounds |x| < 2^(mantissa - 1) to nearest with the integer in the low mantissa bits */
+	template<std::floating_point E>
+	static constexpr E round_shift = sizeof(E) == 4 ? 0x1.8p23 : 0x1.8p52;
+
+	/* x rounded to nearest even and the same integer in the lanes of the matching integer vector */
+	template<float_lanes V>
+	inline __attribute__((__always_inline__)) std::pair<V, lane_mask<V>> round_lanes(V x)
+	{
+		using E = typename lane_traits<V>::type;
+		V s = x + round_shift<E>;
+		return { s - round_shift<E>, (lane_mask<V>)s - (lane_mask<V>)((V){} + round_shift<E>) };
+	}
+
+	/* small integer lanes |n| < 2^(mantissa - 1) to float lanes without the scalarized 64-bit conversion */
+	template<float_lanes V>
+	inline __attribute__((__always_inline__)) V from_int_lanes(lane_mask<V> n)
+	{
+		using E = typename lane_traits<V>::type;
+		return (V)((lane_mask<V>)((V){} + round_shift<E>) + n) - round_shift<E>;
+	}
+
+	/* sine and cosine, Cody-Waite reduction by pi / 2 into [-pi / 4, pi / 4] and odd and even minimax polynomials.
+	   accurate is within 2.5 ulp for |x| up to 8192 in f32 (Cephes sinf) and 2^30 in f64 (Cephes sin), fast within 2e-6
+	   relative error over the same range, larger arguments lose accuracy in the reduction and inf or NaN give NaN */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) std::pair<V,V> sincos_lanes(V x)
+	{
+		using E = typename lane_traits<V>::type;
+		static constexpr bool f32 = sizeof(E) == 4;
+		/* pi / 2 = c1 + c2 + c3 (+ c4 in f32), the leading parts short enough for exact products with the quadrant
+		   without fma */
+		static constexpr E c1 = f32 ? 1.5703125 : 1.57079625129699707031;
+		static constexpr E c2 = f32 ? 4.837512969970703125e-4 : 7.54978941586159635335e-8;
+		static constexpr E c3 = f32 ? 7.54953362047672271729e-8 : 5.39030285815811905290e-15;
+		static constexpr E c4 = 2.56334406825708960298e-12;
+		static constexpr E sp_f32[] = { -1.9515295891e-4, 8.3321608736e-3, -1.6666654611e-1 };
+		static constexpr E cp_f32[] = { 2.443315711809948e-5, -1.388731625493765e-3, 4.166664568298827e-2 };
+		static constexpr E sp_f64[] = { 1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+		                                -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1 };
+		static constexpr E cp_f64[] = { -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+		                                2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2 };
+		static constexpr E sp_fast[] = { 8.16328192360223719e-3, -1.66633903774257090e-1 };
+		static constexpr E cp_fast[] = { -1.36487143562740278e-3, 4.16610713063557583e-2 };
+
+		auto [k, q] = round_lanes(x * (E)(2 / std::numbers::pi));
+		V r = ((x - k * c1) - k * c2) - k * c3;
+		if constexpr(f32)
+			r -= k * c4;
+		V z = r * r, s, c;
+		if constexpr(P == precision::fast)
+			s = horner(z, sp_fast), c = horner(z, cp_fast);
+		else if constexpr(f32)
+			s = horner(z, sp_f32), c = horner(z, cp_f32);
+		else
+			s = horner(z, sp_f64), c = horner(z, cp_f64);
+		s = r + r * z * s;
+		c = (1 - (E)0.5 * z) + z * z * c;
+
+		/* quadrant q of x: odd quadrants swap sine and cosine, the sine is negative in 2 and 3 and the cosine in 1 and 2 */
+		const auto odd = (q & 1) != 0;
+		V sn = odd ? c : s, cs = odd ? s : c;
+		return { (q & 2) != 0 ? -sn : sn, ((q + 1) & 2) != 0 ? -cs : cs };
+	}
+
+	/* sine, see sincos_lanes */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V sin_lanes(V x) { return sincos_lanes<P>(x).first; }
+
+	/* cosine, see sincos_lanes */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V cos_lanes(V x) { return sincos_lanes<P>(x).second; }
+
+	/* angle of (x, y) in [-pi, pi] with the signed zero and infinity cases of std::atan2, the ratio of the smaller to
+	   the larger magnitude is reduced past tan(pi / 8) by one division and evaluated with Cephes atanf in f32 and the
+	   Cephes atan rational in f64. accurate is within 3 ulp, fast within 8e-7 relative error, NaN stays NaN */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V atan2_lanes(V y, V x)
+	{
+		using E = typename lane_traits<V>::type;
+		using I = lane_mask<V>;
+		using L = long double;
+		static constexpr I sign = (I){} + std::numeric_limits<typename lane_traits<I>::type>::min();
+		static constexpr E pio4 = std::numbers::pi_v<E> / 4, pio4_lo = std::numbers::pi_v<L> / 4 - (L)pio4;
+		static constexpr E pio2 = std::numbers::pi_v<E> / 2, pio2_lo = std::numbers::pi_v<L> / 2 - (L)pio2;
+		static constexpr E pi   = std::numbers::pi_v<E>,     pi_lo   = std::numbers::pi_v<L>     - (L)pi;
+		static constexpr E t8   = 0.41421356237309504880;
+		static constexpr E ap_f32[] = { 8.05374449538e-2, -1.38776856032e-1, 1.99777106478e-1, -3.33329491539e-1 };
+		static constexpr E ap_f64[] = { -8.750608600031904122785e-1, -1.615753718733365076637e1, -7.500855792314704667340e1,
+		                                -1.228866684490136173410e2, -6.485021904942025371773e1 };
+		static constexpr E aq_f64[] = { 1, 2.485846490142306297962e1, 1.650270098316988542046e2, 4.328810604912902668951e2,
+		                                4.853903996359136964868e2, 1.945506571482613964425e2 };
+		static constexpr E ap_fast[] = { -1.12251629494145661e-1, 1.97141437423913680e-1, -3.33255077853085005e-1 };
+
+		V ay = (V)((I)y & ~sign), ax = (V)((I)x & ~sign);
+		const auto swap = ay > ax;
+		V num = swap ? ax : ay, den = swap ? ay : ax;
+		/* atan(n / d) = pi / 4 + atan((n - d) / (n + d)) */
+		const auto big = num > t8 * den;
+		V t = (big ? num - den : num) / (big ? num + den : den), z = t * t, a;
+		if constexpr(P == precision::fast)
+			a = t + t * z * horner(z, ap_fast);
+		else if constexpr(sizeof(E) == 4)
+			a = t + t * z * horner(z, ap_f32);
+		else
+			a = t + t * z * (horner(z, ap_f64) / horner(z, aq_f64));
+		a = big ? (a + pio4_lo) + pio4 : a;
+
+		/* equal magnitudes cover both infinite, both zero gives 0 */
+		a = num == den ? (V){} + pio4 : a;
+		a = num + den == 0 ? (V){} : a;
+		a = swap ? (pio2 - a) + pio2_lo : a;
+		a = (I)x < 0 ? (pi - a) + pi_lo : a;
+		return (V)((I)a | ((I)y & sign));
+	}
+
+	/* 2^x, x split into a rounded integer n and f in [-0.5, 0.5] with 2^f from Cephes exp2f in f32 and the Cephes exp2
+	   rational in f64, 2^n applied as two exponent scalings so subnormal results round once. accurate is within 2 ulp,
+	   fast within 3e-6 relative error, large |x| saturate to inf and 0 and NaN stays NaN */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V exp2_lanes(V x)
+	{
+		using E = typename lane_traits<V>::type;
+		using I = lane_mask<V>;
+		static constexpr int M = std::numeric_limits<E>::digits - 1, B = std::numeric_limits<E>::max_exponent - 1;
+		static constexpr E lo = -(B + M + 2), hi = B + 2;
+		static constexpr E ep_f32[] = { 1.535336188319500e-4, 1.339887440266574e-3, 9.618437357674640e-3,
+		                                5.550332471162809e-2, 2.402264791363012e-1, 6.931472028550421e-1 };
+		static constexpr E ep_f64[] = { 2.30933477057345225087e-2, 2.02020656693165307700e1, 1.51390680115615096133e3 };
+		static constexpr E eq_f64[] = { 1, 2.33184211722314911771e2, 4.36821166879210612817e3 };
+		static constexpr E ep_fast[] = { 9.58285303842059719e-3, 5.59064246779435223e-2, 2.40240986116018189e-1, 6.93124193403151413e-1 };
+
+		x = x < lo ? (V){} + lo : x;
+		x = x > hi ? (V){} + hi : x;
+		auto [k, n] = round_lanes(x);
+		V f = x - k, p;
+		if constexpr(P == precision::fast)
+			p = 1 + f * horner(f, ep_fast);
+		else if constexpr(sizeof(E) == 4)
+			p = 1 + f * horner(f, ep_f32);
+		else
+		{
+			V ff = f * f, px = f * horner(ff, ep_f64);
+			p = 1 + 2 * (px / (horner(ff, eq_f64) - px));
+		}
+
+		/* halves of n in the clamped range are normal exponents */
+		I n1 = n >> 1, n2 = n - n1;
+		return p * (V)((n1 + B) << M) * (V)((n2 + B) << M);
+	}
+
+	/* log2(x), x split into 2^e m with m in [sqrt(1/2), sqrt(2)) and log(m) from Cephes logf in f32 and the Cephes log2
+	   rational in f64, subnormals are rescaled first. accurate is within 2 ulp, fast within 2e-6 absolute error near
+	   x = 1 and relative elsewhere, 0 gives -inf, negative lanes NaN and inf stays inf */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V log2_lanes(V x)
+	{
+		using E = typename lane_traits<V>::type;
+		using I = lane_mask<V>;
+		static constexpr int M = std::numeric_limits<E>::digits - 1, B = std::numeric_limits<E>::max_exponent - 1;
+		static constexpr I mantissa = (I){} + (((typename lane_traits<I>::type)1 << M) - 1);
+		static constexpr E log2ea = 0.44269504088896340735992;
+		static constexpr E sqrth = 0.70710678118654752440;
+		static constexpr E lp_f32[] = { 7.0376836292e-2, -1.1514610310e-1, 1.1676998740e-1, -1.2420140846e-1, 1.4249322787e-1,
+		                                -1.6668057665e-1, 2.0000714765e-1, -2.4999993993e-1, 3.3333331174e-1 };
+		static constexpr E lp_f64[] = { 1.01875663804580931796e-4, 4.97494994976747001425e-1, 4.70579119878881725854e0,
+		                                1.44989225341610930846e1, 1.79368678507819816313e1, 7.70838733755885391666e0 };
+		static constexpr E lq_f64[] = { 1, 1.12873587189167450590e1, 4.52279145837532221105e1, 8.29875266912776603211e1,
+		                                7.11544750618563894466e1, 2.31251620126765340583e1 };
+		static constexpr E lp_fast[] = { 1.17818977948286437e-1, -1.84071898125476396e-1, 2.04421876587780664e-1,
+		                                 -2.49438327406450727e-1, 3.33208608883656432e-1 };
+
+		const auto sub = x < std::numeric_limits<E>::min();
+		V s = sub ? x * ((E)((typename lane_traits<I>::type)1 << M)) : x;
+		I e = ((I)s >> M) - (sub ? (I){} + B + M : (I){} + B);
+		V m = (V)(((I)s & mantissa) | (I)((V){} + 1));
+		const auto low = m > 2 * sqrth;
+		e = low ? e + 1 : e;
+		m = low ? m * (E)0.5 : m;
+
+		V f = m - 1, z = f * f, y;
+		if constexpr(P == precision::fast)
+			y = f * z * horner(f, lp_fast);
+		else if constexpr(sizeof(E) == 4)
+			y = f * z * horner(f, lp_f32);
+		else
+			y = f * (z * horner(f, lp_f64) / horner(f, lq_f64));
+		y -= (E)0.5 * z;
+		V r = y * log2ea + f * log2ea + y + f + from_int_lanes<V>(e);
+
+		r = !(x < std::numeric_limits<E>::infinity()) ? x : r;
+		r = x == 0 ? (V){} - std::numeric_limits<E>::infinity() : r;
+		return x < 0 ? (V){} + std::numeric_limits<E>::quiet_NaN() : r;
+	}
+
+	/* hardware reciprocal square root estimates of the AVX and AVX-512 registers, built for their tier and taking the
+	   vector by reference like sqrt_wide, the 64-byte ones in the masked form */
+	inline __attribute__((__target__("avx"))) void rsqrt_estimate(vector_aligned<f32<1>,8>& v) { v = (vector_aligned<f32<1>,8>)_mm256_rsqrt_ps((__m256)v); }
+	inline __attribute__((__target__("avx512f"))) void rsqrt_estimate(vector_aligned<f32<1>,16>& v)
+	{
+		v = (vector_aligned<f32<1>,16>)_mm512_mask_rsqrt14_ps((__m512)v, (__mmask16)-1, (__m512)v);
+	}
+	inline __attribute__((__target__("avx512f"))) void rsqrt_estimate(vector_aligned<f64<1>,8>& v)
+	{
+		v = (vector_aligned<f64<1>,8>)_mm512_mask_rsqrt14_pd((__m512d)v, (__mmask8)-1, (__m512d)v);
+	}
+	inline __attribute__((__target__("avx512f,avx512vl"))) void rsqrt_estimate(vector_aligned<f64<1>,2>& v) { v = (vector_aligned<f64<1>,2>)_mm_rsqrt14_pd((__m128d)v); }
+	inline __attribute__((__target__("avx512f,avx512vl"))) void rsqrt_estimate(vector_aligned<f64<1>,4>& v) { v = (vector_aligned<f64<1>,4>)_mm256_rsqrt14_pd((__m256d)v); }
+
+	/* reciprocal square root, accurate takes the square root of the reciprocal which halves the error of the division
+	   before rounding once more and is within 1 ulp, x is scaled by an even power of two first so the reciprocal never
+	   overflows nor goes subnormal. fast refines the hardware estimate of the tier the register runs at with one
+	   Newton step, or the integer shift estimate with three, within 2e-6 relative error. 0 gives inf and inf 0,
+	   negative and NaN lanes are unspecified in the fast tier */
+	template<precision P = precision::accurate, float_lanes V>
+	inline __attribute__((__always_inline__)) V rsqrt_lanes(V x)
+	{
+		using E = typename lane_traits<V>::type;
+		using I = lane_mask<V>;
+		if constexpr(P == precision::accurate)
+		{
+			static constexpr int H = std::numeric_limits<E>::max_exponent / 2;
+			static constexpr auto pow2 = [](int e) { E p = 1; for(; e > 0; e--) p *= 2; for(; e < 0; e++) p /= 2; return p; };
+			const auto big = x > pow2(H), small = x < pow2(-H);
+			const V r = sqrt_lanes(1 / (big ? x * pow2(-H) : small ? x * pow2(H) : x));
+			return x == 0 ? 1 / x : big ? r * pow2(-H / 2) : small ? r * pow2(H / 2) : r;
+		}
+		else
+		{
+			static constexpr E inf = std::numeric_limits<E>::infinity();
+			auto newton = [&](V y) { return y * ((E)1.5 - ((E)0.5 * x * y) * y); };
+			auto finish = [&](V y) { return x == 0 ? (V){} + inf : x == inf ? (V){} : y; };
+			if constexpr(sizeof(E) == 4 && sizeof(V) == 16)
+				return finish(newton((V)_mm_rsqrt_ps((__m128)x)));
+			else if constexpr(requires(V& y) { rsqrt_estimate(y); })
+				if(simd_has(sizeof(E) == 4 && sizeof(V) == 32 ? simd_tier::avx2 : simd_tier::avx512))
+				{
+					V y = x;
+					rsqrt_estimate(y);
+					return finish(newton(y));
+				}
+			static constexpr I magic = (I){} + (typename lane_traits<I>::type)(sizeof(E) == 4 ? 0x5f375a86 : 0x5fe6eb50c7b537a9);
+			return finish(newton(newton(newton((V)(magic - ((I)x >> 1))))));
+		}
+	}
+
+	/* sum of all lanes of v splat to every lane */
+	template<size_t S = 1, typename V>
+	inline __attribute__((__always_inline__)) V sum_splat(V v)
+	{
+		static constexpr size_t N = lane_traits<V>::size;
+		if constexpr(S >= N)
+			return v;
+		else
+			return sum_splat<2 * S>(v + [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				return __builtin_shufflevector(v, v, (I ^ S)...);
+			}(std::make_index_sequence<N>{}));
+	}
+
+	/* v scaled to unit length over all of its lanes, keep the pad lanes of a pvec zero, zero vectors stay zero */
+	template<precision P = precision::accurate, float_lanes V>
+	inline V normalize(V v)
+	{
+		V d = sum_splat(v * v);
+		if constexpr(P == precision::accurate)
+			return d > 0 ? v / sqrt_lanes(d) : (V){};
+		else
+			return d > 0 ? v * rsqrt_lanes<P>(d) : (V){};
+	}
+
+	/* packet normalization in the given tier, zero length lanes stay zero */
+	template<precision P, typename V, size_t N>
+	inline std::array<V,N> normalize(const std::array<V,N>& a)
+	{
+		if constexpr(P == precision::accurate)
+			return normalize(a);
+		else
+		{
+			V d = dot(a, a), r = d > 0 ? rsqrt_lanes<P>(d) : (V){};
+			std::array<V,N> n;
+			for(size_t c = 0; c < N; c++)
+				n[c] = a[c] * r;
+			return n;
+		}
+	}
+
+	/* out = f(in) over whole registers of the dispatched tier of equally long spans and a zero padded copy of the tail,
+	   f maps an array of NI registers to an array of NO, returns the count */
+	template<sca T, size_t NI, size_t NO, typename F>
+	inline size_t map_lanes(std::array<std::span<const T>,NI> in, std::array<std::span<T>,NO> out, F&& f)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = lanes<T,REG>;
+			using V = vector_aligned<T,W>;
+			using A = packet<T,NI,W>;
+			using R = packet<T,NO,W>;
+			size_t len = std::numeric_limits<size_t>::max(), i = 0;
+			for(const auto& s : in)
+				len = std::min(len, s.size());
+			for(const auto& s : out)
+				len = std::min(len, s.size());
+
+			for(; i + W <= len; i += W)
+			{
+				A v;
+				for(size_t k = 0; k < NI; k++)
+					v[k] = loadu<V>(&in[k][i]);
+				const R r = f(v);
+				for(size_t k = 0; k < NO; k++)
+					storeu(&out[k][i], r[k]);
+			}
+
+			if(i < len)
+			{
+				T pad[NI][W] = {}, res[NO][W];
+				A v;
+				for(size_t k = 0; k < NI; k++)
+				{
+					std::copy_n(&in[k][i], len - i, pad[k]);
+					v[k] = loadu<V>(pad[k]);
+				}
+				const R r = f(v);
+				for(size_t k = 0; k < NO; k++)
+				{
+					storeu(res[k], r[k]);
+					std::copy_n(res[k], len - i, &out[k][i]);
+				}
+			}
+			return len;
+		});
+	}
+
+	/* dst[i] = sin(src[i]), returns the number of values */
+	template<precision P = precision::accurate, sca T>
+	size_t sin(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ sin_lanes<P>(v[0]) }; });
+	}
+
+	/* dst[i] = cos(src[i]) */
+	template<precision P = precision::accurate, sca T>
+	size_t cos(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ cos_lanes<P>(v[0]) }; });
+	}
+
+	/* s[i] = sin(src[i]) and c[i] = cos(src[i]) sharing the reduction */
+	template<precision P = precision::accurate, sca T>
+	size_t sincos(std::span<const T> src, std::span<T> s, std::span<T> c)
+	{
+		return map_lanes<T,1,2>({ src }, { s, c }, [](const auto& v)
+		{
+			auto [sn, cs] = sincos_lanes<P>(v[0]);
+			return std::array{ sn, cs };
+		});
+	}
+
+	/* dst[i] = atan2(y[i], x[i]) */
+	template<precision P = precision::accurate, sca T>
+	size_t atan2(std::span<const T> y, std::span<const T> x, std::span<T> dst)
+	{
+		return map_lanes<T,2,1>({ y, x }, { dst }, [](const auto& v) { return std::array{ atan2_lanes<P>(v[0], v[1]) }; });
+	}
+
+	/* dst[i] = 2^src[i] */
+	template<precision P = precision::accurate, sca T>
+	size_t exp2(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ exp2_lanes<P>(v[0]) }; });
+	}
+
+	/* dst[i] = log2(src[i]) */
+	template<precision P = precision::accurate, sca T>
+	size_t log2(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ log2_lanes<P>(v[0]) }; });
+	}
+
+	/* dst[i] = sqrt(src[i]), correctly rounded in both tiers */
+	template<sca T>
+	size_t sqrt(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ sqrt_lanes(v[0]) }; });
+	}
+
+	/* dst[i] = 1 / sqrt(src[i]) */
+	template<precision P = precision::accurate, sca T>
+	size_t rsqrt(std::span<const T> src, std::span<T> dst)
+	{
+		return map_lanes<T,1,1>({ src }, { dst }, [](const auto& v) { return std::array{ rsqrt_lanes<P>(v[0]) }; });
+	}
+
+	/* dst[i] = src[i] / |src[i]| for 3-vectors, one packet per step with a zero padded tail, zero vectors stay zero,
+	   returns the count */
+	template<precision P = precision::accurate, sca T>
+	size_t normalize(std::span<const vec<T,3>> src, std::span<vec<T,3>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				scatter<T,3,W>(normalize<P>(gather<T,3,W>(&src[i])), &dst[i]);
+
+			if(i < len)
+			{
+				vec<T,3> pad[W] = {};
+				std::copy_n(&src[i], len - i, pad);
+				scatter<T,3,W>(normalize<P>(gather<T,3,W>(pad)), pad);
+				std::copy_n(pad, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+};
@@ -0,0 +1,507 @@
+#pragma once
+
+#include <span>
+
+#include <idlib/math.hpp>
+#include <idlib/soa.hpp>
+#include <idlib/transcendental.hpp>
+
+namespace id::math::type
+{
+	/* F16C and AVX-512 half float conversions, built for their tier and taking the vectors by reference like sqrt_wide
+	   so the clones of the avx2 and avx512 tiers inline them whatever the baseline. 64-byte vectors use the masked
+	   forms to avoid GCC 12 reading _mm512_undefined */
+	inline __attribute__((__target__("f16c"))) void convert_half(const vector_aligned<f32<1>,4>& f, vector_aligned<f16<1>,4>& h)
+	{
+		h = __builtin_shufflevector((vector_aligned<f16<1>,8>)_mm_cvtps_ph((__m128)f, _MM_FROUND_TO_NEAREST_INT), (vector_aligned<f16<1>,8>){}, 0, 1, 2, 3);
+	}
+	inline __attribute__((__target__("f16c"))) void convert_half(const vector_aligned<f32<1>,8>& f, vector_aligned<f16<1>,8>& h)
+	{
+		h = (vector_aligned<f16<1>,8>)_mm256_cvtps_ph((__m256)f, _MM_FROUND_TO_NEAREST_INT);
+	}
+	inline __attribute__((__target__("avx512f"))) void convert_half(const vector_aligned<f32<1>,16>& f, vector_aligned<f16<1>,16>& h)
+	{
+		h = (vector_aligned<f16<1>,16>)_mm512_maskz_cvtps_ph((__mmask16)-1, (__m512)f, _MM_FROUND_TO_NEAREST_INT);
+	}
+	inline __attribute__((__target__("f16c"))) void convert_half(const vector_aligned<f16<1>,4>& h, vector_aligned<f32<1>,4>& f)
+	{
+		f = (vector_aligned<f32<1>,4>)_mm_cvtph_ps((__m128i)__builtin_shufflevector(h, h, 0, 1, 2, 3, 0, 1, 2, 3));
+	}
+	inline __attribute__((__target__("f16c"))) void convert_half(const vector_aligned<f16<1>,8>& h, vector_aligned<f32<1>,8>& f)
+	{
+		f = (vector_aligned<f32<1>,8>)_mm256_cvtph_ps((__m128i)h);
+	}
+	inline __attribute__((__target__("avx512f"))) void convert_half(const vector_aligned<f16<1>,16>& h, vector_aligned<f32<1>,16>& f)
+	{
+		f = (vector_aligned<f32<1>,16>)_mm512_maskz_cvtph_ps((__mmask16)-1, (__m256i)h);
+	}
+
+	/* floats rounded to the nearest half float, ties to even, overflow goes to inf and NaN to a quiet NaN. where the
+	   tier runs F16C (avx2 and up) the instructions keep the upper NaN payload bits while the integer path below
+	   returns the canonical 0x7e00, other values come out the same either way */
+	template<size_t W>
+	inline __attribute__((__always_inline__)) vector_aligned<f16<1>,W> to_half_lanes(vector_aligned<f32<1>,W> f)
+	{
+		if constexpr(requires(vector_aligned<f16<1>,W>& h) { convert_half(f, h); })
+			if(simd_has(W == 16 ? simd_tier::avx512 : simd_tier::avx2))
+			{
+				vector_aligned<f16<1>,W> h;
+				convert_half(f, h);
+				return h;
+			}
+		using U = vector_aligned<u32<1>,W>;
+		U u = (U)f;
+		const U sign = u & 0x80000000u;
+		u ^= sign;
+		/* normal halves rebias the exponent and round the 13 dropped mantissa bits to even */
+		const U n = (u - (112u << 23) + 0xfffu + ((u >> 13) & 1u)) >> 13;
+		/* subnormal halves let the float adder round at 2^-24 by adding 0.5 */
+		const U d = (U)((vector_aligned<f32<1>,W>)u + 0.5f) - 0x3f000000u;
+		U h = u < (113u << 23) ? d : n;
+		h = u >= (143u << 23) ? 0x7c00u : h;
+		h = u > 0x7f800000u ? 0x7e00u : h;
+		return narrow<f16<1>, u32<1>, W>(h | sign >> 16);
+	}
+
+	/* half floats widened exactly to floats, F16C quiets signalling NaNs where the integer path keeps their bits */
+	template<size_t W>
+	inline __attribute__((__always_inline__)) vector_aligned<f32<1>,W> from_half_lanes(vector_aligned<f16<1>,W> h)
+	{
+		if constexpr(requires(vector_aligned<f32<1>,W>& f) { convert_half(h, f); })
+			if(simd_has(W == 16 ? simd_tier::avx512 : simd_tier::avx2))
+			{
+				vector_aligned<f32<1>,W> f;
+				convert_half(h, f);
+				return f;
+			}
+		using U = vector_aligned<u32<1>,W>;
+		using F = vector_aligned<f32<1>,W>;
+		const U x = __builtin_convertvector(h, U);
+		U o = ((x & 0x7fffu) << 13) + (112u << 23);
+		const U e = x & 0x7c00u;
+		/* inf and NaN keep the maximal exponent, subnormals are renormalized by the float subtraction */
+		o = e == 0x7c00u ? o + (112u << 23) : o;
+		const F f = e == 0 ? (F)(o + (1u << 23)) - (F)((U){} + (113u << 23)) : (F)o;
+		return (F)((U)f | (x & 0x8000u) << 16);
+	}
+
+	/* dst[i] = src[i] rounded to the nearest half float, see to_half_lanes, returns the count */
+	inline size_t pack_half(std::span<const f32<1>> src, std::span<f16<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = lanes<f32<1>,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				storeu(&dst[i], to_half_lanes<W>(loadu<vector_aligned<f32<1>,W>>(&src[i])));
+
+			if(i < len)
+			{
+				f32<1> in[W] = {};
+				f16<1> out[W];
+				std::copy_n(&src[i], len - i, in);
+				storeu(out, to_half_lanes<W>(loadu<vector_aligned<f32<1>,W>>(in)));
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* dst[i] = src[i] widened to float, returns the count */
+	inline size_t unpack_half(std::span<const f16<1>> src, std::span<f32<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = lanes<f32<1>,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				storeu(&dst[i], from_half_lanes<W>(loadu<vector_aligned<f16<1>,W>>(&src[i])));
+
+			if(i < len)
+			{
+				f16<1> in[W] = {};
+				f32<1> out[W];
+				std::copy_n(&src[i], len - i, in);
+				storeu(out, from_half_lanes<W>(loadu<vector_aligned<f16<1>,W>>(in)));
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* v in [-1,1] rounded to signed normalized integers of maximum m, NaN lanes give -m */
+	template<rounding R = rounding::nearest, typename V>
+	inline __attribute__((__always_inline__)) auto snorm_lanes(V v, i32<1> m)
+	{
+		using T = typename lane_traits<V>::type;
+		v = v > (T)-1 ? v : (T)-1;
+		v = v < (T)1 ? v : (T)1;
+		return vector_cast_lanes<i32<1>, R, scaling::none, false, T, lane_traits<V>::size>(v * (T)m);
+	}
+
+	/* signed normalized integers of maximum m back to [-1,1] in T, the most negative value also reads -1 */
+	template<sca T, typename Q>
+	inline __attribute__((__always_inline__)) auto from_snorm_lanes(Q q, i32<1> m)
+	{
+		using V = vector_aligned<T,lane_traits<Q>::size>;
+		const V v = __builtin_convertvector(q, V) / (T)m;
+		return v > (T)-1 ? v : (T)-1;
+	}
+
+	/* per mesh dequantization p = q * scale + bias of normalized positions q */
+	template<sca T>
+	struct quantization
+	{
+		vec<T,3> scale, bias;
+	};
+
+	/* scale and bias mapping the bounds of the positions onto [0,1] for unsigned D and [-1,1] for signed D */
+	template<sca D, sca T>
+	quantization<T> quantization_of(std::span<const vec<T,3>> positions)
+	{
+		if(positions.empty())
+			return {};
+		const auto [lo, hi] = simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			packet<T,3,W> lo = broadcast<T,3,W>(positions[0]), hi = lo;
+			auto bound = [&](const packet<T,3,W>& p)
+			{
+				for(size_t c = 0; c < 3; c++)
+				{
+					lo[c] = p[c] < lo[c] ? p[c] : lo[c];
+					hi[c] = p[c] > hi[c] ? p[c] : hi[c];
+				}
+			};
+			size_t i = 0;
+			for(; i + W <= positions.size(); i += W)
+				bound(gather<T,3,W>(&positions[i]));
+			if(i < positions.size())
+			{
+				vec<T,3> pad[W];
+				std::fill_n(pad, W, positions[0]);
+				std::copy(&positions[i], positions.data() + positions.size(), pad);
+				bound(gather<T,3,W>(pad));
+			}
+			std::pair<vec<T,3>, vec<T,3>> r = { positions[0], positions[0] };
+			for(size_t c = 0; c < 3; c++)
+				for(size_t l = 0; l < W; l++)
+				{
+					r.first[c]  = std::min(r.first[c], lo[c][l]);
+					r.second[c] = std::max(r.second[c], hi[c][l]);
+				}
+			return r;
+		});
+		quantization<T> q;
+		for(size_t c = 0; c < 3; c++)
+			if constexpr(std::is_signed_v<D>)
+				q.scale[c] = (hi[c] - lo[c]) / 2, q.bias[c] = (hi[c] + lo[c]) / 2;
+			else
+				q.scale[c] = hi[c] - lo[c], q.bias[c] = lo[c];
+		return q;
+	}
+
+	/* positions quantized to normalized D, snorm for signed and unorm for unsigned D, through q. w is the maximum of D
+	   so a 4-component attribute reads 1, components of a zero scale are 0. returns the count */
+	template<sca D, sca T>
+	size_t quantize(std::span<const vec<T,3>> src, const quantization<T>& q, std::span<vec<D,4>> dst)
+	{
+		static constexpr scaling S = std::is_signed_v<D> ? scaling::snorm : scaling::unorm;
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			const vec<T,3> inv = { q.scale[0] != 0 ? 1 / q.scale[0] : 0, q.scale[1] != 0 ? 1 / q.scale[1] : 0, q.scale[2] != 0 ? 1 / q.scale[2] : 0 };
+			const packet<T,3,W> r = broadcast<T,3,W>(inv), b = broadcast<T,3,W>(q.bias);
+			auto step = [&](const vec<T,3>* s, vec<D,4>* d)
+			{
+				const packet<T,3,W> p = gather<T,3,W>(s);
+				packet<D,4,W> o;
+				for(size_t c = 0; c < 3; c++)
+					o[c] = vector_cast_lanes<D, rounding::nearest, S, true, T, W>((p[c] - b[c]) * r[c]);
+				o[3] = (vector_aligned<D,W>){} + std::numeric_limits<D>::max();
+				scatter<D,4,W>(o, d);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				vec<T,3> in[W] = {};
+				vec<D,4> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* normalized D positions back through q, returns the count */
+	template<sca D, sca T>
+	size_t dequantize(std::span<const vec<D,4>> src, const quantization<T>& q, std::span<vec<T,3>> dst)
+	{
+		static constexpr scaling S = std::is_signed_v<D> ? scaling::snorm : scaling::unorm;
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			const packet<T,3,W> s = broadcast<T,3,W>(q.scale), b = broadcast<T,3,W>(q.bias);
+			auto step = [&](const vec<D,4>* in, vec<T,3>* d)
+			{
+				const packet<D,4,W> p = gather<D,4,W>(in);
+				packet<T,3,W> o;
+				for(size_t c = 0; c < 3; c++)
+					o[c] = vector_cast_lanes<T, rounding::nearest, S, true, D, W>(p[c]) * s[c] + b[c];
+				scatter<T,3,W>(o, d);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				vec<D,4> in[W] = {};
+				vec<T,3> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* GL_INT_2_10_10_10_REV, signed normalized x, y, z and w of 10, 10, 10 and 2 bits from the low bits up, e.g. normals
+	   and tangents with their handedness in w. the unsigned GL_UNSIGNED_INT_2_10_10_10_REV is col::rgba1010102 through
+	   col::convert. returns the count */
+	template<sca T>
+	size_t pack_2_10_10_10_rev(std::span<const vec<T,4>> src, std::span<i32<1>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			auto step = [&](const vec<T,4>* s, i32<1>* d)
+			{
+				const packet<T,4,W> p = gather<T,4,W>(s);
+				storeu(d, (snorm_lanes(p[0], 511) & 0x3ff) | (snorm_lanes(p[1], 511) & 0x3ff) << 10 |
+				          (snorm_lanes(p[2], 511) & 0x3ff) << 20 | snorm_lanes(p[3], 1) << 30);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				vec<T,4> in[W] = {};
+				i32<1> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* GL_INT_2_10_10_10_REV back to [-1,1] components, returns the count */
+	template<sca T>
+	size_t unpack_2_10_10_10_rev(std::span<const i32<1>> src, std::span<vec<T,4>> dst)
+	{
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			using Q = vector_aligned<i32<1>,W>;
+			const size_t len = std::min(src.size(), dst.size());
+			auto step = [&](const i32<1>* s, vec<T,4>* d)
+			{
+				const Q v = loadu<Q>(s);
+				scatter<T,4,W>({ from_snorm_lanes<T>(v << 22 >> 22, 511), from_snorm_lanes<T>(v << 12 >> 22, 511),
+				                 from_snorm_lanes<T>(v << 2 >> 22, 511), from_snorm_lanes<T>(v >> 30, 1) }, d);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				i32<1> in[W] = {};
+				vec<T,4> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* octahedral normal of B = 16, 24 or 32 bits, signed normalized x and y of B / 2 bits from the low bits up, stored
+	   as i8<2>, three little endian bytes and i16<2> */
+	template<size_t B>
+	using oct = std::conditional_t<B == 16, i8<2>, std::conditional_t<B == 24, u8<3>, i16<2>>>;
+
+	/* octahedral projection of unit vectors onto [-1,1]^2, the lower hemisphere folded over the diagonals */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::array<V,2> oct_encode(const std::array<V,3>& n)
+	{
+		using T = typename lane_traits<V>::type;
+		const V ax = n[0] < 0 ? -n[0] : n[0], ay = n[1] < 0 ? -n[1] : n[1], az = n[2] < 0 ? -n[2] : n[2];
+		const V l = ax + ay + az, r = l > 0 ? (T)1 / l : (V){};
+		const V x = n[0] * r, y = n[1] * r;
+		const V fx = ((T)1 - ay * r) * (x < 0 ? (T)-1 : (T)1), fy = ((T)1 - ax * r) * (y < 0 ? (T)-1 : (T)1);
+		return { n[2] < 0 ? fx : x, n[2] < 0 ? fy : y };
+	}
+
+	/* directions of octahedral coordinates, unnormalized */
+	template<typename V>
+	inline __attribute__((__always_inline__)) std::array<V,3> oct_decode(const std::array<V,2>& e)
+	{
+		using T = typename lane_traits<V>::type;
+		const V z = (T)1 - (e[0] < 0 ? -e[0] : e[0]) - (e[1] < 0 ? -e[1] : e[1]), t = z < 0 ? -z : (V){};
+		return { e[0] + (e[0] < 0 ? t : -t), e[1] + (e[1] < 0 ? t : -t), z };
+	}
+
+	/* W octahedral normals of B bits at src as x and y bit fields in 32-bit lanes */
+	template<size_t B, size_t W>
+	inline __attribute__((__always_inline__)) vector_aligned<i32<1>,W> oct_load(const oct<B>* src)
+	{
+		using Q = vector_aligned<i32<1>,W>;
+		if constexpr(B == 16)
+			return __builtin_convertvector(loadu<vector_aligned<u16<1>,W>>(src), Q);
+		else if constexpr(B == 24)
+		{
+			vector_aligned<u8<1>,4 * W> b = {};
+			__builtin_memcpy(&b, src, 3 * W);
+			return (Q)[&]<size_t... I>(std::index_sequence<I...>)
+			{
+				return __builtin_shufflevector(b, (vector_aligned<u8<1>,4 * W>){}, (I % 4 == 3 ? 4 * W : I / 4 * 3 + I % 4)...);
+			}(std::make_index_sequence<4 * W>{});
+		}
+		else
+			return loadu<Q>(src);
+	}
+
+	/* x and y bit fields in 32-bit lanes as W octahedral normals of B bits at dst */
+	template<size_t B, size_t W>
+	inline __attribute__((__always_inline__)) void oct_store(vector_aligned<i32<1>,W> v, oct<B>* dst)
+	{
+		if constexpr(B == 16)
+			storeu(dst, narrow<u16<1>, i32<1>, W>(v));
+		else if constexpr(B == 24)
+		{
+			using U8 = vector_aligned<u8<1>,4 * W>;
+			const U8 b = [&]<size_t... I>(std::index_sequence<I...>)
+			{
+				return __builtin_shufflevector((U8)v, (U8)v, (I < 3 * W ? I / 3 * 4 + I % 3 : 0)...);
+			}(std::make_index_sequence<4 * W>{});
+			__builtin_memcpy(dst, &b, 3 * W);
+		}
+		else
+			storeu(dst, v);
+	}
+
+	/* unit normals to octahedral normals of B bits, fast rounds each coordinate to nearest, accurate keeps the floor or
+	   ceiling of each that decodes closest to the normal. returns the count */
+	template<size_t B, precision P = precision::fast, sca T>
+	size_t encode_oct(std::span<const vec<T,3>> src, std::span<oct<B>> dst)
+	{
+		static_assert(B == 16 || B == 24 || B == 32, "16, 24 or 32-bit octahedral normals");
+		static constexpr i32<1> H = B / 2, M = (1 << (H - 1)) - 1;
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			using V = vector_aligned<T,W>;
+			using Q = vector_aligned<i32<1>,W>;
+			const size_t len = std::min(src.size(), dst.size());
+			auto step = [&](const vec<T,3>* s, oct<B>* d)
+			{
+				const packet<T,3,W> n = gather<T,3,W>(s);
+				const packet<T,2,W> e = oct_encode(n);
+				Q qx = {}, qy = {};
+				if constexpr(P == precision::accurate)
+				{
+					const Q fx = snorm_lanes<rounding::floor>(e[0], M), fy = snorm_lanes<rounding::floor>(e[1], M);
+					/* above any squared sine so the first candidate is kept */
+					V best = {};
+					best += (T)2;
+					for(i32<1> k = 0; k < 4; k++)
+					{
+						Q cx = fx + (k & 1), cy = fy + (k >> 1);
+						cx = cx < M ? cx : M;
+						cy = cy < M ? cy : M;
+						const packet<T,3,W> c = oct_decode(packet<T,2,W>{ from_snorm_lanes<T>(cx, M), from_snorm_lanes<T>(cy, M) });
+						/* squared sine of the angle to the normal, unlike the cosine it keeps its precision near zero
+						   and the candidates all lie within a cell of the normal */
+						const packet<T,3,W> x = cross(c, n);
+						const V sin = dot(x, x) / dot(c, c);
+						const Q m = __builtin_convertvector(sin < best, Q);
+						best = sin < best ? sin : best;
+						qx = m ? cx : qx;
+						qy = m ? cy : qy;
+					}
+				}
+				else
+				{
+					qx = snorm_lanes(e[0], M);
+					qy = snorm_lanes(e[1], M);
+				}
+				oct_store<B,W>((qx & ((1 << H) - 1)) | qy << H, d);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				vec<T,3> in[W] = {};
+				oct<B> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+
+	/* octahedral normals of B bits to unit normals normalized in the tier P, returns the count */
+	template<size_t B, precision P = precision::accurate, sca T>
+	size_t decode_oct(std::span<const oct<B>> src, std::span<vec<T,3>> dst)
+	{
+		static_assert(B == 16 || B == 24 || B == 32, "16, 24 or 32-bit octahedral normals");
+		static constexpr i32<1> H = B / 2, M = (1 << (H - 1)) - 1;
+		return simd_dispatch([&]<size_t REG>()
+		{
+			static constexpr size_t W = block<T,REG>;
+			const size_t len = std::min(src.size(), dst.size());
+			auto step = [&](const oct<B>* s, vec<T,3>* d)
+			{
+				const vector_aligned<i32<1>,W> v = oct_load<B,W>(s);
+				scatter<T,3,W>(normalize<P>(oct_decode(packet<T,2,W>{ from_snorm_lanes<T>(v << (32 - H) >> (32 - H), M),
+				                                                       from_snorm_lanes<T>(v << (32 - B) >> (32 - H), M) })), d);
+			};
+			size_t i = 0;
+
+			for(; i + W <= len; i += W)
+				step(&src[i], &dst[i]);
+
+			if(i < len)
+			{
+				oct<B> in[W] = {};
+				vec<T,3> out[W];
+				std::copy_n(&src[i], len - i, in);
+				step(in, out);
+				std::copy_n(out, len - i, &dst[i]);
+			}
+			return len;
+		});
+	}
+};
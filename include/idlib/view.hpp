@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include <idlib/math.hpp>
+
+namespace id::math::type
+{
+	/* value an element of a view is read into and written from, mat<T,R,C> arrays as std::array of the same layout */
+	template<typename T>
+	using view_value = std::conditional_t<std::is_array_v<T>, std::array<std::remove_extent_t<T>, std::extent_v<T>>, T>;
+
+	/* R-dimensional view of T elements over raw bytes, std::mdspan layout_stride style with strides in bytes so the
+	   records of a mapped file, interleaved vertex attributes or padded image rows are worked on in place. elements are
+	   read and written through memcpy so neither the data nor the strides need to be aligned, const T views are read only */
+	template<typename T, size_t R = 1>
+	class view
+	{
+		static_assert(R >= 1 && R <= 2, "1 or 2 dimensions");
+		static_assert(std::is_trivially_copyable_v<std::remove_all_extents_t<T>>, "memcpy accessed elements");
+		static_assert(sizeof(view_value<T>) == sizeof(T));
+
+		using byte_type = std::conditional_t<std::is_const_v<std::remove_all_extents_t<T>>, const std::byte, std::byte>;
+
+		byte_type* ptr = nullptr;
+		std::array<size_t,R> ext = {};
+		std::array<size_t,R> str = {};
+
+	public:
+		using element_type = T;
+		using value_type = view_value<std::remove_cv_t<T>>;
+
+		/* element proxy, converts to and assigns from the value with unaligned copies */
+		class reference
+		{
+			byte_type* p;
+
+		public:
+			explicit reference(byte_type* p) : p(p) {}
+			operator value_type() const
+			{
+				value_type v;
+				std::memcpy(&v, p, sizeof(v));
+				return v;
+			}
+			const reference& operator=(const value_type& v) const requires (!std::is_const_v<byte_type>)
+			{
+				std::memcpy(p, &v, sizeof(v));
+				return *this;
+			}
+			const reference& operator=(const reference& r) const requires (!std::is_const_v<byte_type>)
+			{
+				return *this = (value_type)r;
+			}
+		};
+
+		view() = default;
+		view(byte_type* data, const std::array<size_t,R>& extents, const std::array<size_t,R>& strides) : ptr(data), ext(extents), str(strides) {}
+
+		/* n elements stride bytes apart from data */
+		view(void* data, size_t n, size_t stride = sizeof(T)) requires (R == 1 && !std::is_const_v<byte_type>)
+			: ptr((byte_type*)data), ext{ n }, str{ stride } {}
+		view(const void* data, size_t n, size_t stride = sizeof(T)) requires (R == 1)
+			: ptr((byte_type*)data), ext{ n }, str{ stride } {}
+
+		/* every whole element of a byte buffer, the first offset bytes in and stride bytes apart */
+		view(std::span<byte_type> bytes, size_t stride = sizeof(T), size_t offset = 0) requires (R == 1)
+			: ptr(bytes.data() + offset), ext{ bytes.size() >= offset + sizeof(T) ? (bytes.size() - offset - sizeof(T)) / stride + 1 : 0 }, str{ stride } {}
+
+		/* rows x cols image, rows pitch bytes apart and elements of a row stride bytes apart */
+		view(void* data, size_t rows, size_t cols, size_t pitch, size_t stride = sizeof(T)) requires (R == 2 && !std::is_const_v<byte_type>)
+			: ptr((byte_type*)data), ext{ rows, cols }, str{ pitch, stride } {}
+		view(const void* data, size_t rows, size_t cols, size_t pitch, size_t stride = sizeof(T)) requires (R == 2)
+			: ptr((byte_type*)data), ext{ rows, cols }, str{ pitch, stride } {}
+
+		/* a span of the same elements, contiguous and aligned */
+		template<typename U> requires (R == 1 && std::is_convertible_v<U(*)[], T(*)[]>)
+		view(std::span<U> s) : ptr((byte_type*)s.data()), ext{ s.size() }, str{ sizeof(T) } {}
+
+		/* a read only view of the same elements */
+		template<typename U> requires (std::is_convertible_v<U(*)[], T(*)[]> && !std::is_same_v<U, T>)
+		view(const view<U,R>& v) : view((byte_type*)v.data(), v.extents(), v.strides()) {}
+
+		byte_type* data() const { return ptr; }
+		const std::array<size_t,R>& extents() const { return ext; }
+		const std::array<size_t,R>& strides() const { return str; }
+		size_t extent(size_t d) const { return ext[d]; }
+		size_t stride(size_t d) const { return str[d]; }
+		size_t size() const { size_t n = 1; for(size_t e : ext) n *= e; return n; }
+		bool empty() const { return size() == 0; }
+
+		reference operator[](size_t i) const requires (R == 1) { return reference(ptr + i * str[0]); }
+		reference operator[](size_t i, size_t j) const requires (R == 2) { return reference(ptr + i * str[0] + j * str[1]); }
+
+		/* the data and every stride are multiples of the alignment of the value type */
+		bool aligned() const
+		{
+			return (uintptr_t)ptr % alignof(value_type) == 0 && std::all_of(str.begin(), str.end(), [](size_t s) { return s % alignof(value_type) == 0; });
+		}
+
+		/* elements back to back, rows of an image back to back too */
+		bool contiguous() const
+		{
+			return str[R - 1] == sizeof(T) && (R == 1 || ext[R - 1] * sizeof(T) == str[0]);
+		}
+
+		/* the elements as a span when the view is contiguous and aligned so kernels can work on it directly */
+		std::optional<std::span<T>> span() const
+		{
+			if(!contiguous() || !aligned())
+				return std::nullopt;
+			return std::span<T>((T*)ptr, size());
+		}
+
+		/* count elements from first, mirrors std::span so views pass through parallel() */
+		view subspan(size_t first, size_t count) const requires (R == 1)
+		{
+			return view(ptr + first * str[0], std::array<size_t,1>{ count }, str);
+		}
+
+		/* row i of an image */
+		view<T> row(size_t i) const requires (R == 2)
+		{
+			return view<T>(ptr + i * str[0], std::array<size_t,1>{ ext[1] }, std::array<size_t,1>{ str[1] });
+		}
+
+		/* an image whose rows are back to back as one run of rows x cols elements */
+		std::optional<view<T>> flat() const requires (R == 2)
+		{
+			if(str[0] != ext[1] * str[1])
+				return std::nullopt;
+			return view<T>(ptr, std::array<size_t,1>{ size() }, std::array<size_t,1>{ str[1] });
+		}
+
+		/* bytes from the first to past the last element, empty views cover none */
+		std::pair<const std::byte*, const std::byte*> bounds() const
+		{
+			if(empty())
+				return { ptr, ptr };
+			size_t last = sizeof(T);
+			for(size_t d = 0; d < R; d++)
+				last += (ext[d] - 1) * str[d];
+			return { ptr, ptr + last };
+		}
+	};
+
+	template<typename T>
+	view(std::span<T>) -> view<T>;
+
+	/* bytes a staged chunk of apply_views() fills for all of its views together */
+	static constexpr size_t view_chunk_bytes = 16 << 10;
+
+	/* element wise span kernel k over equally indexed views or spans, k gets one span per argument and returns its
+	   count, e.g. apply_views([&](auto s, auto d) { return transform_points<float>(m, s, d); }, view<const vec3_t>(positions),
+	   positions) over the position attribute of a mapped vertex buffer. const views are inputs, gathered before k runs,
+	   the others are outputs, scattered after. views that are contiguous and aligned are passed through, the rest are
+	   copied in chunks through aligned stack buffers. an output overlapping an input is always staged so transforms in
+	   place work as long as each output element only covers bytes of input elements at or before its index. returns
+	   the count */
+	template<typename K, typename... S>
+	size_t apply_views(K&& k, S... spans)
+	{
+		static constexpr size_t C = sizeof...(S);
+		static constexpr bool output[] = { !std::is_const_v<std::remove_all_extents_t<typename S::element_type>>... };
+		const size_t n = std::min({ spans.size()... });
+		return [&]<size_t... I>(std::index_sequence<I...>)
+		{
+			const std::tuple<view<typename S::element_type>...> views = { view<typename S::element_type>(spans).subspan(0, n)... };
+
+			/* which views go through the buffers */
+			const std::pair<const std::byte*, const std::byte*> range[] = { std::get<I>(views).bounds()... };
+			auto overlaps = [&](size_t a)
+			{
+				for(size_t b = 0; b < C; b++)
+					if(!output[b] && range[a].first < range[b].second && range[b].first < range[a].second)
+						return true;
+				return false;
+			};
+			const bool staged[] = { (!std::get<I>(views).span() || (output[I] && overlaps(I)))... };
+			if(std::none_of(staged, staged + C, [](bool s) { return s; }))
+				return k(*std::get<I>(views).span()...);
+
+			/* buffers of B elements each, cache line aligned, left uninitialized */
+			static constexpr size_t B = std::max<size_t>(16, view_chunk_bytes / (sizeof(typename S::element_type) + ...) / 16 * 16);
+			static constexpr size_t sizes[] = { (B * sizeof(typename S::element_type) + 63) / 64 * 64 ... };
+			static constexpr std::array<size_t, C> offsets = []()
+			{
+				std::array<size_t, C> o = {};
+				for(size_t j = 1; j < C; j++)
+					o[j] = o[j - 1] + sizes[j - 1];
+				return o;
+			}();
+			alignas(64) std::byte storage[offsets[C - 1] + sizes[C - 1]];
+
+			size_t count = 0;
+			for(size_t first = 0; first < n; first += B)
+			{
+				const size_t len = std::min(B, n - first);
+				auto arg = [&]<size_t J>(std::integral_constant<size_t, J>)
+				{
+					using T = std::tuple_element_t<J, std::tuple<typename S::element_type...>>;
+					using V = view_value<std::remove_cv_t<T>>;
+					const auto v = std::get<J>(views).subspan(first, len);
+					if(!staged[J])
+						return std::span<T>(v.span()->data(), len);
+					V* buffer = (V*)&storage[offsets[J]];
+					if(!output[J])
+					{
+						if(v.contiguous())
+							std::memcpy(buffer, v.data(), len * sizeof(V));
+						else
+							for(size_t i = 0; i < len; i++)
+								buffer[i] = v[i];
+					}
+					return std::span<T>((T*)buffer, len);
+				};
+				const size_t done = k(arg(std::integral_constant<size_t, I>{})...);
+				auto scatter = [&]<size_t J>(std::integral_constant<size_t, J>)
+				{
+					using V = view_value<std::remove_cv_t<std::tuple_element_t<J, std::tuple<typename S::element_type...>>>>;
+					if constexpr(output[J])
+						if(staged[J])
+						{
+							const auto v = std::get<J>(views).subspan(first, done);
+							const V* buffer = (const V*)&storage[offsets[J]];
+							if(v.contiguous())
+								std::memcpy(v.data(), buffer, done * sizeof(V));
+							else
+								for(size_t i = 0; i < done; i++)
+									v[i] = buffer[i];
+						}
+				};
+				(scatter(std::integral_constant<size_t, I>{}), ...);
+				count += done;
+				if(done < len)
+					break;
+			}
+			return count;
+		}(std::index_sequence_for<S...>{});
+	}
+};